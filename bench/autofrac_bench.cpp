@@ -0,0 +1,340 @@
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+#include "fractal/edge.h"
+#include "fractal/face.h"
+#include "fractal/inputreader.h"
+#include "fractal/job.h"
+#include "fractal/structure.h"
+#include "fractal/structureprinter.h"
+#include "fractal/subdivisioncontext.h"
+#include "fractal/subdivisionmatrices.h"
+#include "utils/outputsink.h"
+#include "utils/point2d.h"
+#include "utils/utils.h"
+
+// benchmarks of the hot paths of the cli, results are written as json to compare the runs of several versions:
+// micro benchmarks time one function called in a loop, macro benchmarks time the stages of a whole export
+// on the examples and on synthetic grids of quads of growing size
+
+namespace {
+
+// keeps the compiler from removing the computation of value
+template<typename T>
+void keep(T const& value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+struct Result {
+    std::string name;
+    std::string kind;
+    std::uint64_t iterations;
+    // nanoseconds per iteration of each sample
+    std::vector<double> samples;
+};
+
+struct Settings {
+    std::string filter;
+    // a sample runs at least this long
+    double minSampleSeconds = 0.05;
+    unsigned int nbSamples = 5;
+    std::vector<unsigned int> gridSizes = { 8, 32, 96 };
+};
+
+class Bench {
+public:
+    explicit Bench(Settings settings) : m_settings(std::move(settings)) {}
+
+    // fn runs one iteration, the nb of iterations of a sample doubles until it lasts minSampleSeconds
+    void run(std::string const& name, std::string const& kind, std::function<void()> const& fn) {
+        if (name.find(m_settings.filter) == std::string::npos) {
+            return;
+        }
+        std::cerr << name << std::endl;
+        fn();
+        std::uint64_t iterations = 1;
+        while (this->time(fn, iterations) < m_settings.minSampleSeconds && iterations < (std::uint64_t { 1 } << 40)) {
+            iterations *= 2;
+        }
+        Result result { name, kind, iterations, {} };
+        for (unsigned int i = 0; i < m_settings.nbSamples; i++) {
+            result.samples.push_back(this->time(fn, iterations) * 1e9 / static_cast<double>(iterations));
+        }
+        m_results.push_back(std::move(result));
+    }
+
+    void writeJson(std::ostream& out) const {
+        std::time_t now = std::time(nullptr);
+        char date[32];
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+        out << "{\n";
+        out << "  \"context\": {\n";
+        out << "    \"date\": \"" << date << "\",\n";
+        out << "    \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n";
+        out << "    \"samples\": " << m_settings.nbSamples << ",\n";
+        out << "    \"min_sample_seconds\": " << m_settings.minSampleSeconds << "\n";
+        out << "  },\n";
+        out << "  \"benchmarks\": [";
+        for (std::size_t i = 0; i < m_results.size(); i++) {
+            Result const& r = m_results[i];
+            std::vector<double> sorted = r.samples;
+            std::sort(sorted.begin(), sorted.end());
+            double mean = 0.0;
+            for (double s: sorted) {
+                mean += s / static_cast<double>(sorted.size());
+            }
+            out << (i == 0 ? "\n" : ",\n");
+            out << "    {\"name\": \"" << r.name << "\", \"kind\": \"" << r.kind << "\", \"iterations\": " << r.iterations
+                << ", \"ns_per_op_median\": " << sorted[sorted.size() / 2] << ", \"ns_per_op_min\": " << sorted.front()
+                << ", \"ns_per_op_mean\": " << mean << ", \"ns_per_op_samples\": [";
+            for (std::size_t s = 0; s < r.samples.size(); s++) {
+                out << (s == 0 ? "" : ", ") << r.samples[s];
+            }
+            out << "]}";
+        }
+        out << "\n  ]\n}\n";
+    }
+
+private:
+    static double time(std::function<void()> const& fn, std::uint64_t iterations) {
+        auto start = std::chrono::steady_clock::now();
+        for (std::uint64_t i = 0; i < iterations; i++) {
+            fn();
+        }
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    Settings m_settings;
+    std::vector<Result> m_results;
+};
+
+// grid of size x size quads with cantor edges on top and bottom and bezier edges on the sides, as struct_3x6.txt,
+// one coordinate per vertex so that it is read with autoCoord
+std::string gridStructure(unsigned int size) {
+    std::ostringstream out;
+    out << "f\n";
+    for (unsigned int i = 0; i < size * size; i++) {
+        out << "C_2_0 - B_2_0 - C_2_0 - B_2_0 / C_2_0 - B_2_0 - B_2_0 / 0 / 1\n";
+    }
+    out << "c\n";
+    for (unsigned int row = 0; row < size; row++) {
+        for (unsigned int col = 0; col < size; col++) {
+            unsigned int face = row * size + col;
+            if (col + 1 < size) {
+                out << face << ".3 / " << face + 1 << ".1\n";
+            }
+            if (row + 1 < size) {
+                out << face << ".2 / " << face + size << ".0\n";
+            }
+        }
+    }
+    out << "p\n";
+    for (unsigned int row = 0; row < size; row++) {
+        for (unsigned int col = 0; col < size; col++) {
+            // top right, top left, bottom left then bottom right
+            out << col + 1 << ' ' << row << '\n' << col << ' ' << row << '\n' << col << ' ' << row + 1 << '\n' << col + 1 << ' ' << row + 1 << '\n';
+        }
+    }
+    return out.str();
+}
+
+void microBenchmarks(Bench& bench) {
+    std::string const name = "C_2_0 - B_2_0 - C_2_0 - B_2_0 / C_2_0 - B_2_0 - B_2_0 / 0 / 1";
+    frac::EdgeList edges;
+    edges.emplace_back(frac::EdgeType::CANTOR, 2);
+    edges.emplace_back(frac::EdgeType::BEZIER, 2);
+    edges.emplace_back(frac::EdgeType::CANTOR, 2);
+    edges.emplace_back(frac::EdgeType::BEZIER, 2);
+    frac::EdgeList rotated = edges;
+    std::rotate(rotated.begin(), rotated.begin() + 1, rotated.end());
+
+    bench.run("face/construct_first", "micro", [&] {
+        frac::SubdivisionContext context;
+        frac::Face face(context, edges);
+        keep(face);
+    });
+    frac::SubdivisionContext context;
+    bench.run("face/construct_interned", "micro", [&] {
+        frac::Face face(context, edges);
+        keep(face);
+    });
+    bench.run("face/construct_rotated_interned", "micro", [&] {
+        frac::Face face(context, rotated);
+        keep(face);
+    });
+    bench.run("face/from_str", "micro", [&] {
+        frac::Face face = frac::Face::fromStr(context, name);
+        keep(face);
+    });
+    frac::Face face1(context, edges);
+    frac::Face face2(context, rotated);
+    frac::Face face3(context, edges, 1);
+    bench.run("face/equal_same", "micro", [&] {
+        keep(face1 == face2);
+    });
+    bench.run("face/equal_different", "micro", [&] {
+        keep(face1 == face3);
+    });
+
+    bench.run("utils/split_char", "micro", [&] {
+        keep(frac::utils::split(name, ' '));
+    });
+    bench.run("utils/split_string", "micro", [&] {
+        keep(frac::utils::split(name, " / "));
+    });
+    float value = 0.123456f;
+    bench.run("utils/to_string", "micro", [&] {
+        keep(frac::utils::to_string(value));
+    });
+
+    frac::Point2D p0(0.0f, 0.0f);
+    frac::Point2D p1(1.0f, 2.0f);
+    frac::Point2D p2(3.0f, 1.0f);
+    frac::Point2D p3(4.0f, 0.0f);
+    float t = 0.3f;
+    bench.run("bezier/point_on_quad_curve", "micro", [&] {
+        keep(frac::utils::coordOfPointOnQuadCurveAt(t, p0, p1, p2));
+    });
+    bench.run("bezier/point_on_cubic_curve", "micro", [&] {
+        keep(frac::utils::coordOfPointOnCubicCurveAt(t, p0, p1, p2, p3));
+    });
+    unsigned int nbPieces = 4;
+    bench.run("bezier/matrices_quad_precomputed", "micro", [&] {
+        keep(frac::SubdivisionMatrices<2>::get(nbPieces));
+    });
+    bench.run("bezier/matrices_cubic_precomputed", "micro", [&] {
+        keep(frac::SubdivisionMatrices<3>::get(nbPieces));
+    });
+    unsigned int manyPieces = 64;
+    bench.run("bezier/matrices_cubic_cached", "micro", [&] {
+        keep(frac::SubdivisionMatrices<3>::get(manyPieces));
+    });
+    frac::Edge bezier(frac::EdgeType::BEZIER, 3);
+    bench.run("bezier/edge_piece_matrix", "micro", [&] {
+        keep(frac::edgePieceMatrix(bezier, 2, 1));
+    });
+}
+
+// closure, printing and whole export of the structure of the file
+void macroBenchmarks(Bench& bench, std::string const& label, std::string const& filename, std::filesystem::path const& workDir) {
+    auto build = [&filename](frac::SubdivisionContext& context, std::unique_ptr<frac::Structure>& structure, std::unique_ptr<frac::InputReader>& reader) {
+        reader = std::make_unique<frac::InputReader>(context);
+        if (!reader->read(filename)) {
+            std::cerr << reader->error() << std::endl;
+            std::exit(1);
+        }
+        structure = std::make_unique<frac::Structure>(context, reader->faces(), frac::BezierType::Quadratic_Bezier, frac::CantorType::Classic_Cantor);
+        for (frac::Adjacency const& adj: reader->constraints()) {
+            structure->addAdjacency(adj);
+        }
+    };
+
+    bench.run("closure/" + label, "macro", [&] {
+        frac::SubdivisionContext context;
+        std::unique_ptr<frac::InputReader> reader;
+        std::unique_ptr<frac::Structure> structure;
+        build(context, structure, reader);
+        keep(structure->graph().nbCells());
+    });
+
+    frac::SubdivisionContext context;
+    std::unique_ptr<frac::InputReader> reader;
+    std::unique_ptr<frac::Structure> structure;
+    build(context, structure, reader);
+    structure->graph();
+    std::string noLibrary = (workDir / "library/").string();
+    bench.run("print/" + label, "macro", [&] {
+        frac::MemorySink sink;
+        frac::StructurePrinter printer(*structure, true, sink, 0, noLibrary);
+        printer.exportStruct();
+        keep(sink.content().size());
+    });
+
+    frac::JobOptions options;
+    options.input = filename;
+    options.output = (workDir / (label + ".py")).string();
+    options.autoCoord = true;
+    options.libraryPath = noLibrary;
+    bench.run("export/" + label, "macro", [&] {
+        frac::LibraryIndex library;
+        std::ostringstream log;
+        frac::JobResult result = frac::runJob(options, library, log);
+        if (!result.success) {
+            std::cerr << result.error << std::endl;
+            std::exit(1);
+        }
+    });
+}
+
+void printHelp() {
+    std::cout << "usage: ./autofrac_bench [-f filter] [-o path] [-t seconds] [-n N] [-q]" << std::endl;
+    std::cout << "\t-f filter\t\t only run the benchmarks whose name contains filter" << std::endl;
+    std::cout << "\t-o path \t\t path to the json results, default is the standard output" << std::endl;
+    std::cout << "\t-t seconds\t\t minimum duration of a sample, default is 0.05" << std::endl;
+    std::cout << "\t-n N    \t\t nb of samples of each benchmark, default is 5" << std::endl;
+    std::cout << "\t-q      \t\t quick run, smaller synthetic grids" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Settings settings;
+    std::string output;
+    for (int i = 1; i < argc; i++) {
+        std::string option = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (option == "-f" && hasValue) {
+            settings.filter = argv[++i];
+        } else if (option == "-o" && hasValue) {
+            output = argv[++i];
+        } else if (option == "-t" && hasValue) {
+            settings.minSampleSeconds = std::stod(argv[++i]);
+        } else if (option == "-n" && hasValue) {
+            settings.nbSamples = std::max(1ul, std::stoul(argv[++i]));
+        } else if (option == "-q") {
+            settings.gridSizes = { 4, 16 };
+        } else {
+            printHelp();
+            return 1;
+        }
+    }
+
+    std::filesystem::path workDir = std::filesystem::temp_directory_path() / ("autofrac_bench_" + std::to_string(::getpid()));
+    std::filesystem::create_directories(workDir);
+
+    Bench bench(settings);
+    microBenchmarks(bench);
+    std::filesystem::path examples = AUTOFRAC_EXAMPLES_DIR;
+    for (std::string example: { "F", "struct_3x6", "struct_3x6_edge_bezier" }) {
+        macroBenchmarks(bench, example, (examples / (example + ".txt")).string(), workDir);
+    }
+    for (unsigned int size: settings.gridSizes) {
+        std::string label = "grid_" + std::to_string(size) + "x" + std::to_string(size);
+        std::filesystem::path filename = workDir / (label + ".txt");
+        std::ofstream(filename) << gridStructure(size);
+        macroBenchmarks(bench, label, filename.string(), workDir);
+    }
+    std::filesystem::remove_all(workDir);
+
+    if (output.empty()) {
+        bench.writeJson(std::cout);
+    } else {
+        std::ofstream file(output);
+        bench.writeJson(file);
+        if (!file) {
+            std::cerr << output << ": cannot write the file" << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
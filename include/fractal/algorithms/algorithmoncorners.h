@@ -6,7 +6,7 @@
 
 namespace frac::LinksOnCorners {
 
-std::vector<frac::Face> subdivide(frac::Face const& face);
+std::vector<frac::Face> subdivide(frac::Face const& face, frac::SubdivisionContext& context);
 
 }
 
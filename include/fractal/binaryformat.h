@@ -0,0 +1,59 @@
+#ifndef AUTOFRAC_BINARYFORMAT_H
+#define AUTOFRAC_BINARYFORMAT_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "fractal/face.h"
+#include "fractal/structure.h"
+#include "utils/point2d.h"
+
+// binary form of a structure file, every field is little endian and 4 bytes wide:
+// header, face table, edge table, adjacency table, then two float32 per point
+namespace frac::BinaryFormat {
+
+constexpr char s_magic[4] = { 'A', 'F', '2', 'B' };
+constexpr std::uint32_t s_version = 1;
+
+struct Header {
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t nbFaces;
+    std::uint32_t nbEdges;
+    std::uint32_t nbAdjacencies;
+    std::uint32_t nbCoords;
+};
+
+// edges of the face are [firstEdge, firstEdge + nbEdges) in the edge table, edges are Edge::packed() words
+struct FaceRecord {
+    std::uint32_t firstEdge;
+    std::uint32_t nbEdges;
+    std::uint32_t delay;
+    std::uint32_t adjEdge;
+    std::uint32_t gapEdge;
+    std::uint32_t reqEdge;
+    std::uint32_t algo;
+};
+
+struct AdjacencyRecord {
+    std::uint32_t face1;
+    std::uint32_t edge1;
+    std::uint32_t face2;
+    std::uint32_t edge2;
+};
+
+static_assert(sizeof(Header) == 24 && sizeof(FaceRecord) == 28 && sizeof(AdjacencyRecord) == 16, "records must not be padded");
+
+// true if the content starts with the magic of the format
+bool isBinary(std::string_view content);
+// records are read and written as they are in memory, which needs a little endian host
+bool isHostSupported();
+
+// returns false and sets error if the file cannot be written
+bool write(std::string const& filename, std::vector<frac::Face> const& faces, std::vector<frac::Adjacency> const& adjacencies, std::vector<frac::Point2D> const& coords, std::string& error);
+
+}
+
+#endif //AUTOFRAC_BINARYFORMAT_H
@@ -0,0 +1,32 @@
+#ifndef AUTOFRAC_CELLMATRICES_H
+#define AUTOFRAC_CELLMATRICES_H
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "utils/librarypack.h"
+
+namespace frac {
+
+// matrices of the subdivisions of the cells of a graph computed by the cli, one blob of the library format per cell
+class CellMatrices {
+public:
+    CellMatrices() = default;
+    explicit CellMatrices(std::size_t nbCells);
+
+    // the cells of different indices can be set from different threads
+    void set(std::size_t index, std::string blob);
+    // matrices of the cell at index in the graph, nullopt if they are not computed
+    [[nodiscard]] std::optional<frac::MatrixBlob> matrices(std::size_t index) const;
+    [[nodiscard]] std::string const& blob(std::size_t index) const;
+    [[nodiscard]] std::size_t size() const;
+
+private:
+    // an empty blob is a cell without matrices
+    std::vector<std::string> m_blobs;
+};
+
+} // frac
+
+#endif //AUTOFRAC_CELLMATRICES_H
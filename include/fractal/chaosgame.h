@@ -0,0 +1,73 @@
+#ifndef AUTOFRAC_CHAOSGAME_H
+#define AUTOFRAC_CHAOSGAME_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "utils/librarypack.h"
+
+namespace frac {
+
+class CoordinateStore;
+
+class Structure;
+
+// samples the attractor of a structure with the chaos game, from the matrices of the subdivisions of its cells:
+// each cell keeps a point of its attractor, as weights of its control points, which is replaced by the point
+// of one of its subdivisions mapped by the matrix of the subdivision, a point of a face of the structure is
+// written after the points of a few random subdivisions under it are replaced
+class ChaosGame {
+public:
+    // point file: header then x and y of each point as float32, every field is little endian
+    static constexpr char s_magic[4] = { 'A', 'F', 'P', 'C' };
+    static constexpr std::uint32_t s_version = 1;
+
+    struct Header {
+        char magic[4];
+        std::uint32_t version;
+        std::uint64_t nbPoints;
+    };
+
+    static_assert(sizeof(Header) == 16, "records must not be padded");
+
+    // the points of a block are drawn from their own random stream, so a file only depends on the seed, not on the threads
+    static constexpr std::uint64_t s_blockSize = 1 << 16;
+    // nb of subdivisions under a face replaced before a point of the face is written
+    static constexpr unsigned int s_depth = 4;
+    // nb of times the point of each cell is replaced before the first point of a block
+    static constexpr unsigned int s_nbWarmUpSweeps = 32;
+    static constexpr std::uint64_t s_defaultSeed = 0x5eed;
+
+    // coords are the control points of each face of the structure in the order of its cell, the structure must outlive the game
+    ChaosGame(frac::Structure const& structure, frac::CoordinateStore const& coords);
+
+    // matrices of the subdivisions of the cell at index in the graph, returns false and sets error if their sizes do not match
+    bool setMatrices(std::size_t index, frac::MatrixBlob const& matrices, std::string& error);
+    // writes nbPoints points of the attractor to the file on nbThreads threads, every cell must have its matrices,
+    // returns false and sets error if the file cannot be written
+    bool sample(std::string const& filename, std::uint64_t nbPoints, std::uint64_t seed, unsigned int nbThreads, std::string& error) const;
+
+private:
+    // writes the points of the block, samples are the points of the cells
+    void sampleBlock(std::uint64_t block, std::uint64_t seed, std::vector<double>& samples, float* points, std::size_t nbPoints) const;
+    // replaces the point of the cell by the one of its subdivision k
+    void replace(std::vector<double>& samples, std::size_t cell, std::size_t k) const;
+
+    frac::Structure const& m_structure;
+    // index is the index of the cell in the graph, the point of cell i is n values from m_sampleOffsets[i]
+    std::vector<std::size_t> m_nbControlPoints;
+    std::vector<std::size_t> m_sampleOffsets;
+    // the matrix of subdivision k of cell i is m_matrices[m_firstMatrices[i] + k], row by row
+    std::vector<std::size_t> m_firstMatrices;
+    std::vector<std::vector<double>> m_matrices;
+    // index is the index of the face, rows x, y and w of the control points of the face
+    // then for each subdivision of its cell, its matrix mapped to the plane, row by row
+    std::vector<std::size_t> m_faceCells;
+    std::vector<std::vector<double>> m_faceControlPoints;
+    std::vector<std::vector<std::vector<double>>> m_faceMaps;
+};
+
+} // frac
+
+#endif //AUTOFRAC_CHAOSGAME_H
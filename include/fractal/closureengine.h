@@ -0,0 +1,34 @@
+#ifndef AUTOFRAC_CLOSUREENGINE_H
+#define AUTOFRAC_CLOSUREENGINE_H
+
+#include <vector>
+
+#include "fractal/face.h"
+#include "utils/set.h"
+#include "utils/workstealingpool.h"
+
+namespace frac {
+
+class SubdivisionContext;
+
+// computes the cells reachable by subdivision from root faces, the frontier of each
+// breadth first step is subdivided in parallel then added to the context in order,
+// so ids and order of the cells are the same whatever the nb of threads
+class ClosureEngine {
+public:
+    explicit ClosureEngine(frac::SubdivisionContext& context);
+
+    // roots first, then the cells reachable from each root in breadth first order
+    [[nodiscard]] frac::Set<frac::Face> closure(std::vector<frac::Face> const& roots);
+
+private:
+    // subdivisions of faces from index first, the ones not computed yet are computed in parallel
+    std::vector<std::vector<frac::Face> const*> subdivisionsFrom(frac::Set<frac::Face> const& faces, std::size_t first);
+
+    frac::SubdivisionContext& m_context;
+    frac::WorkStealingPool m_pool;
+};
+
+} // frac
+
+#endif //AUTOFRAC_CLOSUREENGINE_H
@@ -0,0 +1,40 @@
+#ifndef AUTOFRAC_CONSTRAINT_H
+#define AUTOFRAC_CONSTRAINT_H
+
+#include <cstdint>
+#include <string_view>
+
+namespace frac {
+
+class OutputSink;
+
+// a boundary of the cell is the boundary of one of its subdivisions:
+// cell(Bord(bord) + Sub(sub), Sub(subFace) + Bord(subFaceBord))
+struct IncidenceConstraint {
+    std::uint32_t cell;
+    std::uint32_t bord;
+    std::uint32_t sub;
+    std::uint32_t subFace;
+    std::uint32_t subFaceBord;
+
+    // writes the python line of the constraint, cellName is the name of the cell
+    void print(frac::OutputSink& output, std::string_view cellName) const;
+};
+
+// two subdivisions of the cell share a boundary:
+// cell(Sub(sub1) + Bord(bord1) + Permut(permut), Sub(sub2) + Bord(bord2))
+struct AdjacencyConstraint {
+    std::uint32_t cell;
+    std::uint32_t sub1;
+    std::uint32_t bord1;
+    std::uint32_t permut;
+    std::uint32_t sub2;
+    std::uint32_t bord2;
+
+    // writes the python line of the constraint, cellName is the name of the cell
+    void print(frac::OutputSink& output, std::string_view cellName) const;
+};
+
+} // frac
+
+#endif //AUTOFRAC_CONSTRAINT_H
@@ -0,0 +1,64 @@
+#ifndef AUTOFRAC_CONSTRAINTSOLVER_H
+#define AUTOFRAC_CONSTRAINTSOLVER_H
+
+#include <string>
+#include <vector>
+
+#include "fractal/cellmatrices.h"
+
+namespace frac {
+
+class Structure;
+
+// solves the incidence and adjacency constraints of the cells instead of the python model_init.solve():
+// the entries of the matrices of the subdivisions of a cell are the variables, the constraints of the cell
+// are linear equations on them with constant edge pieces and selections of control points, so each cell is
+// a sparse system A x = b, and the solution is the one nearest to the initial matrices,
+// x = x0 + At y with A At y = b - A x0 solved by conjugate gradients, cells are solved in parallel
+// the edge adjacencies of a cell are identities on the control points, they add no equation
+class ConstraintSolver {
+public:
+    // the iterations stop when no equation is off by more than s_tolerance, or after s_maxIterations
+    static constexpr double s_tolerance = 1e-12;
+    static constexpr unsigned int s_maxIterations = 10000;
+
+    // the structure must outlive the solver
+    explicit ConstraintSolver(frac::Structure const& structure);
+
+    // solves the cells from their initial matrices on nbThreads threads,
+    // returns false and sets error if the initial matrices of a cell are missing or have wrong sizes
+    bool solve(frac::CellMatrices const& initial, unsigned int nbThreads, std::string& error);
+    [[nodiscard]] frac::CellMatrices const& matrices() const;
+    // largest error of an equation after the solve
+    [[nodiscard]] double residual() const;
+    // nb of iterations of the slowest cell
+    [[nodiscard]] unsigned int nbIterations() const;
+
+private:
+    // compressed sparse rows of the equations of a cell
+    struct System {
+        std::vector<std::size_t> rowOffsets = { 0 };
+        std::vector<std::size_t> columns;
+        std::vector<double> values;
+        std::vector<double> rhs;
+
+        void addEquation(std::size_t column1, double value1, std::size_t column2, double value2, double rhs);
+        [[nodiscard]] std::size_t nbRows() const;
+        // res = A x and res = At y
+        void multiply(std::vector<double> const& x, std::vector<double>& res) const;
+        void multiplyTransposed(std::vector<double> const& y, std::vector<double>& res) const;
+    };
+
+    // blob of the solved matrices of the cell, returns false and sets error if its initial matrices do not match it
+    bool solveCell(std::size_t index, frac::MatrixBlob const& initial, std::string& blob, std::string& error, double& residual, unsigned int& nbIterations) const;
+
+    frac::Structure const& m_structure;
+    frac::CellMatrices m_matrices;
+    // index is the index of the cell in the graph
+    std::vector<double> m_residuals;
+    std::vector<unsigned int> m_nbIterations;
+};
+
+} // frac
+
+#endif //AUTOFRAC_CONSTRAINTSOLVER_H
@@ -0,0 +1,34 @@
+#ifndef AUTOFRAC_CONTROLPOINTLAYOUT_H
+#define AUTOFRAC_CONTROLPOINTLAYOUT_H
+
+#include <vector>
+
+#include "fractal/edge.h"
+#include "fractal/face.h"
+
+namespace frac {
+
+// indices of the control points of a face, edge i goes from control point
+// firstControlPoint(i) to firstControlPoint(i + 1), modulo the nb of control points
+class ControlPointLayout {
+public:
+    ControlPointLayout(frac::Face const& face, frac::BezierType bezierType, frac::CantorType cantorType);
+
+    [[nodiscard]] std::size_t nbControlPoints() const;
+    [[nodiscard]] std::size_t nbEdges() const;
+    [[nodiscard]] std::size_t firstControlPoint(std::size_t indexEdge) const;
+    [[nodiscard]] std::size_t nbInternControlPoints(std::size_t indexEdge) const;
+    [[nodiscard]] bool isInternControlPoint(std::size_t indexControlPoint) const;
+    [[nodiscard]] bool isControlPointBelongEdge(std::size_t indexControlPoint, std::size_t indexEdge) const;
+    // first, intern and last control points of the edge
+    [[nodiscard]] std::vector<std::size_t> controlPointIndices(std::size_t indexEdge, bool reverse = false) const;
+
+private:
+    // prefix sums of the control points of the edges, the last one is the nb of control points
+    std::vector<std::size_t> m_firstControlPoints;
+    std::vector<bool> m_internControlPoints;
+};
+
+} // frac
+
+#endif //AUTOFRAC_CONTROLPOINTLAYOUT_H
@@ -1,9 +1,12 @@
 #ifndef EDGE_H
 #define EDGE_H
 
+#include <cstdint>
+#include <functional>
 #include <ostream>
 #include <string>
-#include <vector>
+
+#include "utils/smallvector.h"
 
 namespace frac {
 
@@ -11,30 +14,48 @@ enum class EdgeType {
     CANTOR, BEZIER
 };
 
-enum class CantorType {
-    Classic_Cantor,
-    Quadratic_Cantor,
-    Cubic_Cantor
+// the value of a cantor or bezier type is the degree of its curves, the named types are the common ones
+// but any degree up to s_maxDegree is valid, from 1 for cantor edges and from 2 for bezier edges
+constexpr unsigned int s_maxDegree = 7;
+
+enum class CantorType : unsigned int {
+    Classic_Cantor = 1,
+    Quadratic_Cantor = 2,
+    Cubic_Cantor = 3
 };
 
-enum class BezierType {
-    Quadratic_Bezier,
-    Cubic_Bezier
+enum class BezierType : unsigned int {
+    Quadratic_Bezier = 2,
+    Cubic_Bezier = 3
 };
 
+constexpr unsigned int degree(frac::CantorType cantorType) {
+    return static_cast<unsigned int>(cantorType);
+}
+
+constexpr unsigned int degree(frac::BezierType bezierType) {
+    return static_cast<unsigned int>(bezierType);
+}
+
 class Edge {
 public:
+    // largest values that fit in the packed word, the constructor throws std::out_of_range above them
+    static constexpr unsigned int s_maxNbSubdivisions = 0x7FFF;
+    static constexpr unsigned int s_maxDelay = 0xFFFF;
+
     Edge(frac::Edge const& other) = default;
     Edge(frac::EdgeType edgeType, unsigned int nbSubdivisions, unsigned int delay = 0);
     Edge& operator=(const frac::Edge& other) = default;
     static Edge fromStr(std::string const& name);
+    // edge whose packed() is the given word
+    static Edge fromPacked(std::uint32_t packed);
 
     void decreaseDelay();
     [[nodiscard]] frac::EdgeType edgeType() const;
     [[nodiscard]] unsigned int nbSubdivisions() const;
     [[nodiscard]] unsigned int nbActualSubdivisions() const;
     [[nodiscard]] unsigned int delay() const;
-    [[nodiscard]] std::vector<frac::Edge> subdivisions(frac::Edge const& reqEdge) const;
+    [[nodiscard]] frac::SmallVector<frac::Edge, 8> subdivisions(frac::Edge const& reqEdge) const;
     [[nodiscard]] bool isDelay() const;
     [[nodiscard]] std::string name() const;
     void setEdgeType(frac::EdgeType edgeType);
@@ -44,20 +65,42 @@ public:
     friend std::ostream& operator<<(std::ostream& os, frac::Edge const& edge);
     bool operator==(frac::Edge const& other) const;
     bool operator!=(frac::Edge const& other) const;
+    bool operator<(frac::Edge const& other) const;
 
     [[nodiscard]] std::string toString() const;
+    [[nodiscard]] std::size_t hash() const;
+    [[nodiscard]] std::uint32_t packed() const;
 
     std::size_t nbControlPoints(BezierType bezierType, CantorType cantorType) const;
     std::size_t nbInternControlPoints(BezierType bezierType, CantorType cantorType) const;
 
 private:
-    frac::EdgeType m_edgeType;
-    unsigned int m_nbSubdivisions;
-    unsigned int m_delay;
+    // the edge type is the highest bit, then 15 bits for the number of subdivisions
+    // and 16 bits for the delay, so comparing words compares type, subdivisions then delay
+    std::uint32_t m_packed;
+
+    static constexpr std::uint32_t s_typeShift = 31;
+    static constexpr std::uint32_t s_nbSubdivisionsShift = 16;
+    static constexpr std::uint32_t s_nbSubdivisionsMask = s_maxNbSubdivisions;
+    static constexpr std::uint32_t s_delayMask = s_maxDelay;
 };
 
+// edges of a face, most faces have less than 8 edges so they are stored inline
+using EdgeList = frac::SmallVector<frac::Edge, 8>;
+
 } // frac
 
+namespace std {
+
+template<>
+struct hash<frac::Edge> {
+    std::size_t operator()(frac::Edge const& edge) const {
+        return edge.hash();
+    }
+};
+
+} // std
+
 #endif // EDGE_H
 
 
@@ -0,0 +1,263 @@
+#ifndef AUTOFRAC_EDGESTATEEMITTER_H
+#define AUTOFRAC_EDGESTATEEMITTER_H
+
+#include <array>
+#include "fractal/edge.h"
+#include "fractal/subdivisionmatrices.h"
+#include "utils/floatformat.h"
+#include "utils/outputsink.h"
+#include "utils/utils.h"
+
+namespace frac {
+
+// python text depending on the nb of intern control points of an edge state
+template<unsigned int NbIntern>
+struct InternControlPoints {
+    // Intern_('') if there is only one, Intern_('0'), Intern_('1')... otherwise
+    static void printName(frac::OutputSink& out, unsigned int index) {
+        if constexpr (NbIntern > 1) {
+            out.print(index);
+        }
+    }
+
+    static void printSpace(frac::OutputSink& out) {
+        out.print("[Bord_('0'), ");
+        for (unsigned int i = 0; i < NbIntern; ++i) {
+            out.print("Intern_('");
+            printName(out, i);
+            out.print("'), ");
+        }
+        out.print("Bord_('1')]");
+    }
+
+    static void printGrid(frac::OutputSink& out) {
+        out.print("[Figure(1, ");
+        printSpace(out);
+        out.print(")]");
+    }
+
+    // the permutation reverses the intern control points
+    static void printPermut(frac::OutputSink& out, unsigned int index) {
+        out.print("(Permut('0') + Intern('");
+        printName(out, index);
+        out.print("'), Intern('");
+        printName(out, NbIntern - 1 - index);
+        out.print("'))");
+    }
+
+    // constant matrix placing the intern control point of a delayed state on the one of its subdivision
+    static void printDelayMatrix(frac::OutputSink& out, unsigned int index) {
+        out.print(".initMat[Sub_('0') + Intern('");
+        printName(out, index);
+        out.println("')] = FMat([");
+        for (unsigned int row = 0; row < NbIntern + 2; ++row) {
+            out.print("        [", row == index + 1 ? "1.0" : "0.0");
+            if (row + 1 < NbIntern + 2) {
+                out.println("],");
+            } else {
+                out.print("]]).setTyp('Const')");
+            }
+        }
+    }
+};
+
+// writes the python states of the edges of one type, Prefix is 'B' or 'C', a delay of 0 is an edge without delay
+template<char Prefix, unsigned int NbIntern>
+class EdgeStateEmitter {
+public:
+    using Intern = InternControlPoints<NbIntern>;
+    static constexpr unsigned int s_nbIntern = NbIntern;
+
+    static void printName(frac::OutputSink& out, unsigned int n, unsigned int delay) {
+        out.print(Prefix, n);
+        if (delay != 0) {
+            out.print('_', delay);
+        }
+    }
+
+    static void printDecl(frac::OutputSink& out, unsigned int n, unsigned int delay) {
+        line(out, n, delay, " = Etat('");
+        printName(out, n, delay);
+        out.println("', ", NbIntern, ")");
+        line(out, n, delay, ".bords = {Bord('0'): s, Bord('1'): s}\n");
+        line(out, n, delay, ".permuts = {Permut('0'): ");
+        printName(out, n, delay);
+        out.println("}");
+    }
+
+    static void printDelayImpl(frac::OutputSink& out, unsigned int n, unsigned int delay) {
+        line(out, n, delay, ".subs = {Sub('0'): ");
+        printName(out, n, delay - 1);
+        out.println("}");
+        line(out, n, delay, ".buildIntern()\n");
+        line(out, n, delay, ".space = ");
+        Intern::printSpace(out);
+        out.println();
+        line(out, n, delay, "(Permut('0') + Bord('0'), Bord('1'))\n");
+        line(out, n, delay, "(Permut('0') + Bord('1'), Bord('0'))\n");
+        for (unsigned int i = 0; i < NbIntern; ++i) {
+            line(out, n, delay);
+            Intern::printPermut(out, i);
+            out.println();
+        }
+        line(out, n, delay, "(Permut('0') + Sub('0'), Sub('0') + Permut('0'))\n");
+        line(out, n, delay, "(Bord('0') + Sub('0'), Sub('0') + Bord('0'))\n");
+        line(out, n, delay, "(Bord('1') + Sub('0'), Sub('0') + Bord('1'))\n");
+        line(out, n, delay, ".grid.elems = ");
+        Intern::printGrid(out);
+        out.println();
+        line(out, n, delay, ".prim.elems = [Figure(1, [Bord_('0'), Bord_('1')])]\n");
+        for (unsigned int i = 0; i < NbIntern; ++i) {
+            line(out, n, delay);
+            Intern::printDelayMatrix(out, i);
+            out.println();
+        }
+    }
+
+    // values row by row, each row of nbColumns values
+    template<std::size_t Size>
+    static void printMatrix(frac::OutputSink& out, std::array<float, Size> const& values, std::size_t nbColumns, frac::FloatFormat const& format) {
+        for (std::size_t i = 0; i < Size; i += nbColumns) {
+            out.print("        [");
+            for (std::size_t j = 0; j < nbColumns; ++j) {
+                if (j != 0) {
+                    out.print(", ");
+                }
+                out.appendFloat(values[i + j], format);
+            }
+            out.println(i + nbColumns < Size ? "]," : "]]).setTyp('Const')");
+        }
+    }
+
+protected:
+    // indented line starting with the name of the state
+    template<typename... Pieces>
+    static void line(frac::OutputSink& out, unsigned int n, unsigned int delay, Pieces const& ... pieces) {
+        out.print("    ");
+        printName(out, n, delay);
+        out.print(pieces...);
+    }
+
+    static void printSubs(frac::OutputSink& out, unsigned int n) {
+        line(out, n, 0, ".subs = {");
+        for (unsigned int i = 0; i < n - 1; ++i) {
+            out.print("Sub('", i, "'): ");
+            printName(out, n, 0);
+            out.print(", ");
+        }
+        out.print("Sub('", n - 1, "'): ");
+        printName(out, n, 0);
+        out.println("}");
+    }
+};
+
+// states of the bezier edges of degree Degree
+template<unsigned int Degree>
+class BezierEmitter : public EdgeStateEmitter<'B', Degree - 1> {
+public:
+    using Base = EdgeStateEmitter<'B', Degree - 1>;
+    using typename Base::Intern;
+
+    static void printStateImpl(frac::OutputSink& out, unsigned int n, frac::FloatFormat const& format) {
+        Base::printSubs(out, n);
+        Base::line(out, n, 0, ".buildIntern()\n");
+        Base::line(out, n, 0, ".space = ");
+        Intern::printSpace(out);
+        out.println();
+        Base::line(out, n, 0, "(Permut('0') + Bord('0'), Bord('1'))\n");
+        Base::line(out, n, 0, "(Permut('0') + Bord('1'), Bord('0'))\n");
+        for (unsigned int i = 0; i < Base::s_nbIntern; ++i) {
+            Base::line(out, n, 0);
+            Intern::printPermut(out, i);
+            out.println();
+        }
+        for (unsigned int i = 0; i < n; ++i) {
+            Base::line(out, n, 0, "(Permut('0') + Sub(", i, "), Sub(", n - i - 1, ") + Permut('0'))\n");
+        }
+        Base::line(out, n, 0, ".grid.elems = ");
+        Intern::printGrid(out);
+        out.println();
+        Base::line(out, n, 0, ".prim.elems = [Figure(1, [Bord_('0'), Bord_('1')])]\n");
+        auto matrices = frac::SubdivisionMatrices<Degree>::get(n);
+        for (unsigned int i = 0; i < n; ++i) {  // for each subdivision T0, T1, ... Tn-1
+            Base::line(out, n, 0, ".initMat[Sub_('", i, "')] = FMat([\n");
+            Base::printMatrix(out, matrices[i], Degree + 1, format);
+        }
+    }
+};
+
+// states of the cantor edges of degree Degree, the classic cantor edges are of degree 1
+template<unsigned int Degree>
+class CantorEmitter : public EdgeStateEmitter<'C', Degree - 1> {
+public:
+    using Base = EdgeStateEmitter<'C', Degree - 1>;
+    using typename Base::Intern;
+
+    static void printStateImpl(frac::OutputSink& out, unsigned int n, frac::FloatFormat const& format) {
+        Base::printSubs(out, n);
+        Base::line(out, n, 0, ".buildIntern()\n");
+        Base::line(out, n, 0, ".space = ");
+        Intern::printSpace(out);
+        out.println();
+        Base::line(out, n, 0, "(Permut('0') + Bord('0'), Bord('1'))\n");
+        Base::line(out, n, 0, "(Permut('0') + Bord('1'), Bord('0'))\n");
+        for (unsigned int i = 0; i < n; ++i) {
+            Base::line(out, n, 0, "(Permut('0') + Sub('", i, "'), Sub('", n - i - 1, "') + Permut('0'))\n");
+        }
+        for (unsigned int i = 0; i < Base::s_nbIntern; ++i) {
+            Base::line(out, n, 0);
+            Intern::printPermut(out, i);
+            out.println();
+        }
+        Base::line(out, n, 0, "(Bord('0') + Sub('0'), Sub('0') + Bord('0'))\n");
+        Base::line(out, n, 0, "(Bord('1') + Sub('0'), Sub(", n - 1, ") + Bord('1'))\n");
+        Base::line(out, n, 0, ".grid.elems = ");
+        Intern::printGrid(out);
+        out.println();
+
+        if constexpr (Degree == 1) {
+            unsigned int m = n * 2 - 1;
+            unsigned int prem = m - 1;
+            unsigned int deux = 1;
+            Base::line(out, n, 0, ".initMat[Sub_('0') + Bord('1')] = FMat([\n");
+            Base::printMatrix(out, std::array<float, 2> { float(prem) / float(m), float(deux) / float(m) }, 1, format);
+            prem = prem - 1;
+            deux = deux + 1;
+            for (unsigned int j = 0; j < n - 2; ++j) {
+                Base::line(out, n, 0, ".initMat[Sub_('", j + 1, "')] = FMat([\n");
+                Base::printMatrix(out, std::array<float, 4> { float(prem) / float(m), float(prem - 1) / float(m), float(deux) / float(m), float(deux + 1) / float(m) }, 2, format);
+                prem = prem - 2;
+                deux = deux + 2;
+            }
+            Base::line(out, n, 0, ".initMat[Sub_('", n - 1, "') + Bord('0')] = FMat([\n");
+            Base::printMatrix(out, std::array<float, 2> { float(prem) / float(m), float(deux) / float(m) }, 1, format);
+        } else {
+            // the pieces of the curve are one over two pieces of the curve cut in 2n - 1
+            auto matrices = frac::SubdivisionMatrices<Degree>::get(n + n - 1);
+            for (unsigned int i = 0; i < n; ++i) {  // for each subdivision T0, T1, ... Tn-1
+                Base::line(out, n, 0, ".initMat[Sub_('", i, "')] = FMat([\n");
+                Base::printMatrix(out, matrices[2 * i], Degree + 1, format);
+            }
+        }
+    }
+};
+
+// the emitter functions of one edge type and degree
+struct EdgeStateEmitters {
+    void (* printDecl)(frac::OutputSink& out, unsigned int n, unsigned int delay);
+    void (* printDelayImpl)(frac::OutputSink& out, unsigned int n, unsigned int delay);
+    void (* printStateImpl)(frac::OutputSink& out, unsigned int n, frac::FloatFormat const& format);
+
+    template<typename Emitter>
+    static constexpr frac::EdgeStateEmitters of() {
+        return { &Emitter::printDecl, &Emitter::printDelayImpl, &Emitter::printStateImpl };
+    }
+};
+
+// emitters of the degree of the type, chosen once for all the edges of a structure
+frac::EdgeStateEmitters bezierEmitters(frac::BezierType bezierType);
+frac::EdgeStateEmitters cantorEmitters(frac::CantorType cantorType);
+
+} // frac
+
+#endif //AUTOFRAC_EDGESTATEEMITTER_H
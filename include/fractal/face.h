@@ -1,10 +1,9 @@
 #ifndef AUTOFRAC_FACE_H
 #define AUTOFRAC_FACE_H
 
-#include <map>
 #include <optional>
+#include <string>
 #include <vector>
-#include <unordered_map>
 
 #include "fractal/algorithms/algorithmsubdivision.h"
 #include "fractal/edge.h"
@@ -12,19 +11,36 @@
 
 namespace frac {
 
+// identifies a cell whatever the rotation of its edges, the edges start at their least rotation
+struct FaceKey {
+    frac::EdgeList edges;
+    unsigned int delay;
+    frac::Edge adjEdge;
+    frac::Edge gapEdge;
+    frac::Edge reqEdge;
+    frac::AlgorithmSubdivision algo;
+
+    bool operator==(FaceKey const& other) const;
+};
+
+struct FaceKeyHash {
+    std::size_t operator()(FaceKey const& key) const;
+};
+
+class SubdivisionContext;
+
 class Face {
 public:
-    Face() : Face(std::vector<frac::Edge> {}) {}
-
-    explicit Face(std::vector<frac::Edge> edges, unsigned int delay = 0, const frac::Edge& adjEdge = { frac::EdgeType::CANTOR, 2 }, const frac::Edge& gapEdge = { frac::EdgeType::BEZIER, 2 }, const frac::Edge& reqEdge = { frac::EdgeType::BEZIER, 2 }, AlgorithmSubdivision algo = AlgorithmSubdivision::LinksSurroundDelayAndBezier);
-    static Face fromStr(std::string const& name);
+    // the face is interned in the context, which must outlive it
+    Face(frac::SubdivisionContext& context, frac::EdgeList edges, unsigned int delay = 0, const frac::Edge& adjEdge = { frac::EdgeType::CANTOR, 2 }, const frac::Edge& gapEdge = { frac::EdgeType::BEZIER, 2 }, const frac::Edge& reqEdge = { frac::EdgeType::BEZIER, 2 }, AlgorithmSubdivision algo = AlgorithmSubdivision::LinksSurroundDelayAndBezier);
+    static Face fromStr(frac::SubdivisionContext& context, std::string const& name);
 
-    [[nodiscard]] std::vector<frac::Edge> const& constData() const;
-    [[nodiscard]] std::vector<frac::Edge>& data();
+    [[nodiscard]] frac::EdgeList const& constData() const;
     [[nodiscard]] int firstInterior() const;
     [[nodiscard]] int lastInterior() const;
     [[nodiscard]] std::size_t len() const;
-    [[nodiscard]] std::string name() const;
+    [[nodiscard]] std::size_t id() const;
+    [[nodiscard]] std::string const& name() const;
     [[nodiscard]] std::size_t offset() const;
     [[nodiscard]] frac::Edge adjEdge() const;
     [[nodiscard]] frac::Edge gapEdge() const;
@@ -34,50 +50,47 @@ public:
 
     [[nodiscard]] std::optional<frac::Edge> edgeIfRequired(frac::Edge const& edge) const;
 
-    void setAdjEdge(frac::Edge const& edge);
-    void setGapEdge(frac::Edge const& edge);
-    void setReqEdge(frac::Edge const& edge);
-    void setDelay(unsigned int delay);
     void setFirstInterior(int index);
-    void setAlgo(AlgorithmSubdivision algo);
-    [[nodiscard]] std::vector<frac::Face> subdivisions() const;
+    [[nodiscard]] std::vector<frac::Face> const& subdivisions() const;
     [[nodiscard]] frac::Set<frac::Face> allSubdivisions() const;
 
     frac::Edge const& operator[](std::size_t index) const;
     bool operator==(frac::Face const& other) const;
     friend std::ostream& operator<<(std::ostream& os, const frac::Face& face);
 
-    [[nodiscard]] std::string toString() const;
-
-    static std::map<std::string, std::string> s_incidenceConstraints;
-    static std::map<std::string, std::string> s_adjacencyConstraints;
-    static void reset();
-
-    static void addAdjacencyConstraint(frac::Face const& face, frac::Face const& faceSub1, frac::Face const& faceSub2, unsigned int indexSubFace1, unsigned int indexBordFace1, unsigned int indexSubFace2, unsigned int indexBordFace2);
-    static void addIncidenceConstraint(frac::Face const& face, frac::Face const& faceSub, unsigned int indexParentEdge, unsigned int indexSubEdge, unsigned int indexSubFaceEdge, unsigned int indexSubFace);
-
-    // key is name of the cell (since it is unique)
-    static std::unordered_map<std::string, std::vector<frac::Face>> s_subdivisions;
+    // string of the cell, its edges are in the order of the face that created it, from which offsets are counted
+    [[nodiscard]] std::string const& toString() const;
+    [[nodiscard]] frac::FaceKey key() const;
+    [[nodiscard]] std::size_t hash() const;
+    [[nodiscard]] frac::SubdivisionContext& context() const;
 
     std::size_t nbControlPoints(BezierType bezierType, CantorType cantorType) const;
 
 private:
-    std::vector<frac::Edge> m_data;
+    frac::SubdivisionContext* m_context;
+    frac::EdgeList m_data;
     unsigned int m_delay;
     frac::Edge m_adjEdge;
     frac::Edge m_gapEdge;
     frac::Edge m_reqEdge;
-    std::string m_name;
+    std::size_t m_id;
     std::size_t m_offset;
+    std::size_t m_rotation;
     int m_firstInterior;
     frac::AlgorithmSubdivision m_algo;
+};
 
-    static frac::Set<frac::Face> s_existingFaces;
+} // frac
 
+namespace std {
 
-    static std::size_t computeOffset(frac::Face const& face, frac::Face const& other);
+template<>
+struct hash<frac::Face> {
+    std::size_t operator()(frac::Face const& face) const {
+        return face.hash();
+    }
 };
 
-} // frac
+} // std
 
 #endif //AUTOFRAC_FACE_H
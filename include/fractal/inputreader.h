@@ -0,0 +1,58 @@
+#ifndef AUTOFRAC_INPUTREADER_H
+#define AUTOFRAC_INPUTREADER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "fractal/face.h"
+#include "fractal/structure.h"
+#include "utils/point2d.h"
+
+namespace frac {
+
+class SubdivisionContext;
+
+// reads a structure file: after a line starting with 'f' each line is a face,
+// after 'c' an adjacency between two faces and after 'p' the coordinates of a point,
+// lines starting with '#' and blank lines are ignored, the file may also be in the binary format
+class InputReader {
+public:
+    explicit InputReader(frac::SubdivisionContext& context);
+
+    // returns false if the file cannot be read or is malformed, error() then tells why
+    bool read(std::string const& filename);
+    // same as read with the content of a text file, the name is only used in errors
+    bool parse(std::string_view content, std::string const& filename);
+    // same as read with the content of a binary file
+    bool parseBinary(std::string_view content, std::string const& filename);
+
+    [[nodiscard]] std::vector<frac::Face> const& faces() const;
+    [[nodiscard]] std::vector<frac::Adjacency> const& constraints() const;
+    // coordinates of all points, in the order of the file
+    [[nodiscard]] std::vector<frac::Point2D> const& coords() const;
+    // "file:line:column: message" of the first error
+    [[nodiscard]] std::string const& error() const;
+
+private:
+    bool parseFace(std::string_view line);
+    bool parseConstraint(std::string_view line);
+    bool parseCoord(std::string_view line);
+    bool parseEdge(std::string_view token, frac::Edge& edge);
+    bool parseUnsigned(std::string_view token, unsigned int& value);
+    // sets the error at the position of token in the current line and returns false
+    bool fail(std::string_view token, std::string const& message);
+
+    frac::SubdivisionContext& m_context;
+    std::vector<frac::Face> m_faces;
+    std::vector<frac::Adjacency> m_constraints;
+    std::vector<frac::Point2D> m_coords;
+    std::string m_error;
+    std::string m_filename;
+    std::string_view m_line;
+    std::size_t m_lineNumber = 0;
+};
+
+} // frac
+
+#endif //AUTOFRAC_INPUTREADER_H
@@ -0,0 +1,64 @@
+#ifndef AUTOFRAC_JOB_H
+#define AUTOFRAC_JOB_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "utils/floatformat.h"
+#include "utils/libraryindex.h"
+
+namespace frac {
+
+// what is needed to turn one input file into one python file
+struct JobOptions {
+    std::string input;
+    // "-" is the standard output
+    std::string output = "output.py";
+    bool autoCoord = false;
+    // degree of the bezier edges, from 2 to s_maxDegree
+    unsigned int bezierDegree = 2;
+    // degree of the cantor edges, from 1 to s_maxDegree, 1 is the classic cantor
+    unsigned int cantorDegree = 1;
+    unsigned int nbIterAutoSubs = 0;
+    // subdivision points of the cells not in the library placed by the spring–mass solver of the cli instead of the script
+    bool solveSubs = false;
+    // constraints of the cells solved by the cli from the matrices of the library, or of the spring–mass solver,
+    // the solved matrices are saved in the library folder, the script only solves the adjacencies of the init cells
+    bool solveConstraints = false;
+    // if not 0, the output is a point file of nbPoints points of the attractor instead of the script
+    std::uint64_t nbPoints = 0;
+    // a library folder or pack
+    std::string libraryPath = "library/";
+    frac::FloatFormat floatFormat;
+    // 0 uses the nb of hardware threads
+    unsigned int nbThreads = 0;
+};
+
+struct JobResult {
+    bool success = false;
+    std::string error;
+    double seconds = 0;
+    std::size_t nbCellStates = 0;
+    std::size_t nbEdgeStates = 0;
+    std::uint64_t nbPoints = 0;
+    // largest error of a constraint solved by the cli
+    double constraintsResidual = 0;
+    std::size_t subdivisionsHits = 0;
+    std::size_t subdivisionsMisses = 0;
+};
+
+// reads the input, builds the structure and exports it, progress is written to log
+frac::JobResult runJob(frac::JobOptions const& options, frac::LibraryIndex& library, std::ostream& log);
+
+// one job per line: the input, the output then the options of the command line (-a, -c, -d N, -e N, -g N, -i N, -j N, -l path, -p format, -s, -x),
+// lines starting with '#' and blank lines are ignored, returns false and sets error if the manifest is malformed
+bool readManifest(std::string const& filename, std::vector<frac::JobOptions>& jobs, std::string& error);
+
+// runs the jobs on nbThreads threads, largest input first, results are in the order of the jobs
+std::vector<frac::JobResult> runJobs(std::vector<frac::JobOptions> const& jobs, unsigned int nbThreads);
+
+} // frac
+
+#endif //AUTOFRAC_JOB_H
@@ -0,0 +1,52 @@
+#ifndef AUTOFRAC_SPRINGMASSSOLVER_H
+#define AUTOFRAC_SPRINGMASSSOLVER_H
+
+#include <string>
+#include <vector>
+
+#include "fractal/cellmatrices.h"
+
+namespace frac {
+
+class Structure;
+
+// places the subdivision points of the cells of a structure with a spring–mass system, instead of the python autoSubBar,
+// the control points of the subdivisions on the boundary of a cell are fixed by the subdivisions of its edges,
+// the other ones are moved to the mean of their neighbours along the edges of the subdivisions until they stay still
+// a point is a combination of the control points of the cell, so the points are the matrices of the subdivisions of the cell
+// and do not depend on the coordinates of the structure, as the matrices of the library
+class SpringMassSolver {
+public:
+    // the sweeps stop when no point moves more than s_tolerance, or after s_maxIterations sweeps
+    static constexpr double s_tolerance = 1e-12;
+    static constexpr unsigned int s_maxIterations = 100000;
+
+    // the structure must outlive the solver
+    explicit SpringMassSolver(frac::Structure const& structure);
+
+    // solves the cells of the graph of the structure, on nbThreads threads
+    void solve(unsigned int nbThreads);
+    // one matrix per subdivision of each cell, one row per control point of the cell
+    // and one column per control point of the subdivision, empty before solve
+    [[nodiscard]] frac::CellMatrices const& matrices() const;
+    // nb of sweeps of the slowest cell
+    [[nodiscard]] unsigned int nbIterations() const;
+    // nb of cells stopped by s_maxIterations before their points stayed still
+    [[nodiscard]] std::size_t nbUnconverged() const;
+
+private:
+    // blob of the matrices of the cell, nbIterations is the nb of sweeps it took,
+    // converged is true if the last sweep moved no point more than s_tolerance
+    std::string solveCell(std::size_t index, unsigned int& nbIterations, bool& converged) const;
+
+    frac::Structure const& m_structure;
+    frac::CellMatrices m_matrices;
+    // index is the index of the cell in the graph
+    std::vector<unsigned int> m_nbIterations;
+    // not a vector of bool, the cells are solved on several threads
+    std::vector<char> m_converged;
+};
+
+} // frac
+
+#endif //AUTOFRAC_SPRINGMASSSOLVER_H
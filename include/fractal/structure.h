@@ -1,12 +1,15 @@
 #ifndef AUTOFRAC_FRAC_STRUCTURE_H
 #define AUTOFRAC_FRAC_STRUCTURE_H
 
+#include <memory>
 #include <ostream>
 #include <string>
 #include <vector>
 
+#include "fractal/controlpointlayout.h"
 #include "fractal/face.h"
-#include "utils/set.h"
+#include "fractal/subdivisioncontext.h"
+#include "fractal/subdivisiongraph.h"
 
 namespace frac {
 
@@ -28,17 +31,20 @@ struct Adjacency {
 
 class Structure {
 public:
-    explicit Structure(std::vector<frac::Face> const& faces, frac::BezierType bezierType, frac::CantorType cantorType);
+    // the faces must have been created in the context, which must outlive the structure
+    explicit Structure(frac::SubdivisionContext& context, std::vector<frac::Face> const& faces, frac::BezierType bezierType, frac::CantorType cantorType);
 
     void addAdjacency(Adjacency const& adj);
+    // python lines of the adjacencies, built on each call
     std::string strAdjacencies() const;
     std::vector<Adjacency> const& adjacencies() const;
-    frac::Set<frac::Edge> allEdges() const;
-    frac::Set<frac::Face> allFaces() const;
+    // built the first time it is needed, faces of the structure must not change afterwards
+    frac::SubdivisionGraph const& graph() const;
 
     std::vector<frac::Face> const& faces() const;
 
     std::size_t nbControlPointsOfFace(std::size_t indexFace) const;
+    frac::ControlPointLayout const& layout(std::size_t indexFace) const;
     std::vector<std::size_t> controlPointIndices(std::size_t indexEdge, std::size_t indexFace, bool reverse = false) const;
 
     bool isInternControlPoint(std::size_t indexControlPoint, std::size_t indexFace) const;
@@ -49,13 +55,17 @@ public:
 
     frac::BezierType bezierType() const;
     frac::CantorType cantorType() const;
+    frac::SubdivisionContext& context() const;
 
 private:
+    frac::SubdivisionContext& m_context;
     std::vector<frac::Face> m_faces;
-    std::string m_strAdjacency;
     std::vector<Adjacency> m_adjacencies;
+    // index is the index of the face
+    std::vector<frac::ControlPointLayout> m_layouts;
     frac::BezierType m_bezierType;
     frac::CantorType m_cantorType;
+    mutable std::unique_ptr<frac::SubdivisionGraph> m_graph;
 };
 
 } // frac
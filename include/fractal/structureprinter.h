@@ -3,35 +3,40 @@
 
 #include <vector>
 #include <string>
-#include "utils/fileprinter.h"
+#include "fractal/cellmatrices.h"
+#include "fractal/edge.h"
+#include "utils/libraryindex.h"
+#include "utils/outputsink.h"
+#include "utils/set.h"
 
 namespace frac {
 
-class Edge;
-
 class Face;
 
-class Point2D;
+class CoordinateStore;
 
 class Structure;
 
 class StructurePrinter {
 public:
-    explicit StructurePrinter(frac::Structure const& structure, bool planarControlPoints, std::string filename, unsigned int nbIterAutoSubs, std::string libPath, std::vector<std::vector<Point2D>> const& coords = {});
+    // the script is written to output as it is generated, output is flushed at the end of exportStruct
+    // the control points are at the origin if coords is nullptr or empty, coords must outlive the printer
+    // libPath is a library folder or pack, library is shared with other printers if given, otherwise the printer reads it itself
+    explicit StructurePrinter(frac::Structure const& structure, bool planarControlPoints, frac::OutputSink& output, unsigned int nbIterAutoSubs, std::string libPath, frac::CoordinateStore const* coords = nullptr, frac::LibraryIndex* library = nullptr);
+    // fixed 4 digits by default
+    void setFloatFormat(frac::FloatFormat const& format);
+    // the matrices of the cells that are not in the library are the ones of matrices, which must outlive the printer
+    void setFallbackMatrices(frac::CellMatrices const* matrices);
+    // matrices of all the cells solved by the cli, they are neither placed nor saved by the script,
+    // which only solves the adjacencies of the init cells if the structure has some
+    void setSolvedMatrices(frac::CellMatrices const* matrices);
     void exportStruct();
 private:
     void print_header();
     void print_vertex_state();
-    void print_decl_of_edge(frac::Edge const& edge);
-    void print_delay_cantor_decl(unsigned int n, unsigned int delay_count);
-    void print_cantor_n_state_decl(unsigned int n);
-    void print_delay_bezier_decl(unsigned int n, unsigned int delay_count);
-    void print_bezier_state_decl(unsigned int n);
-    void print_impl_of_edge(frac::Edge const& edge);
-    void print_delay_cantor_impl(unsigned int n, unsigned int delay_count);
-    void print_cantor_n_state_impl(unsigned int n);
-    void print_delay_bezier_impl(unsigned int n, unsigned int delay_count);
-    void print_bezier_state_impl(unsigned int n);
+    // declarations then implementations of the edge states
+    void print_edge_states(frac::Set<frac::Edge> const& edges);
+    void print_edge_name(frac::Edge const& edge);
     void print_init_subds();
     void print_edges_of_cell(frac::Face const& cell);
     void print_subd_of_cell(frac::Face const& cell);
@@ -40,16 +45,22 @@ private:
     void print_edge_adjacencies_of_cell(frac::Face const& cell);
     void print_plan_control_points();
     void print_plan_coords_control_points();
+    // python list of the rows of the matrix index of matrices
+    void print_matrix(frac::MatrixBlob const& matrices, std::size_t index);
     void print_footer();
 
 private:
     frac::Structure const& m_structure;
     bool m_planarControlPoints;
-    std::string const m_filename;
-    std::vector<std::vector<Point2D>> const& m_coords;
-    frac::FilePrinter m_filePrinter;
+    frac::CoordinateStore const* m_coords;
+    frac::OutputSink& m_output;
+    frac::FloatFormat m_floatFormat;
     const unsigned int m_nbIterAutoSubs;
     std::string m_libPath;
+    frac::LibraryIndex m_ownLibrary;
+    frac::LibraryIndex* m_library;
+    frac::CellMatrices const* m_fallbackMatrices = nullptr;
+    frac::CellMatrices const* m_solvedMatrices = nullptr;
 };
 }
 #endif //AUTOFRAC_STRUCTUREPRINTER_H
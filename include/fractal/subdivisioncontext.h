@@ -0,0 +1,100 @@
+#ifndef AUTOFRAC_SUBDIVISIONCONTEXT_H
+#define AUTOFRAC_SUBDIVISIONCONTEXT_H
+
+#include <deque>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "fractal/constraint.h"
+#include "fractal/face.h"
+#include "utils/span.h"
+
+namespace frac {
+
+// owns the cells created while building one structure: their ids, subdivisions and constraints
+// a context is not thread safe, but independent contexts can be used from different threads,
+// and cells can be staged concurrently as long as the context is not modified meanwhile
+class SubdivisionContext {
+public:
+    SubdivisionContext();
+    // faces keep a pointer to their context
+    SubdivisionContext(SubdivisionContext const& other) = delete;
+    SubdivisionContext& operator=(SubdivisionContext const& other) = delete;
+
+    [[nodiscard]] std::optional<std::size_t> findCell(frac::FaceKey const& key) const;
+    // the face becomes the reference of the new cell, returns the id of the cell
+    std::size_t addCell(frac::FaceKey key, frac::Face const& face);
+    [[nodiscard]] frac::Face const& cell(std::size_t id) const;
+    [[nodiscard]] std::size_t nbCells() const;
+
+    [[nodiscard]] std::string const& cellName(std::size_t id);
+    [[nodiscard]] std::string const& cellString(std::size_t id);
+
+    [[nodiscard]] std::vector<frac::Face> const& subdivisions(std::size_t id);
+    [[nodiscard]] bool hasSubdivisions(std::size_t id) const;
+    // subdivides the cell in a new context that only reads this one, new cells and constraints stay in the new context
+    [[nodiscard]] std::unique_ptr<frac::SubdivisionContext> stageSubdivisions(std::size_t id) const;
+    // adds the cells and constraints staged for the cell, in the same order as subdivisions(id) would
+    std::vector<frac::Face> const& commitSubdivisions(std::size_t id, frac::SubdivisionContext const& staging);
+    [[nodiscard]] std::size_t subdivisionsHits() const;
+    [[nodiscard]] std::size_t subdivisionsMisses() const;
+
+    void addAdjacencyConstraint(frac::Face const& face, frac::Face const& faceSub1, frac::Face const& faceSub2, unsigned int indexSubFace1, unsigned int indexBordFace1, unsigned int indexSubFace2, unsigned int indexBordFace2);
+    void addIncidenceConstraint(frac::Face const& face, frac::Face const& faceSub, unsigned int indexParentEdge, unsigned int indexSubEdge, unsigned int indexSubFaceEdge, unsigned int indexSubFace);
+    // constraints of the cell, the span is valid until constraints are added
+    [[nodiscard]] frac::Span<frac::IncidenceConstraint const> incidenceConstraints(std::size_t id) const;
+    [[nodiscard]] frac::Span<frac::AdjacencyConstraint const> adjacencyConstraints(std::size_t id) const;
+
+    // nb threads used to compute closures of cells, default is the nb of hardware threads
+    void setNbThreads(unsigned int nbThreads);
+    [[nodiscard]] unsigned int nbThreads() const;
+
+private:
+    // constraint recorded by a staging context, indices are the ones given to add*Constraint
+    struct StagedConstraint {
+        bool adjacency;
+        unsigned int indices[4];
+    };
+
+    explicit SubdivisionContext(frac::SubdivisionContext const* parent);
+    static std::vector<frac::Face> subdivide(frac::Face const& face, frac::SubdivisionContext& context);
+    // string of the cache of the cell, the one of the staging context for a cell of the parent
+    std::string& cachedString(std::vector<std::string>& cache, std::unordered_map<std::size_t, std::string>& parentCache, std::size_t id);
+    // subdivisions of a cell that has them, from the context that owns the cell
+    [[nodiscard]] std::vector<frac::Face> const& knownSubdivisions(std::size_t id) const;
+
+    // set for a staging context, cells with an id lower than m_firstId are the ones of the parent
+    frac::SubdivisionContext const* m_parent = nullptr;
+    std::size_t m_firstId = 0;
+    std::vector<frac::Face> m_stagedSubdivisions;
+    std::vector<StagedConstraint> m_stagedConstraints;
+    // strings of the cells of the parent asked to a staging context, key is the id of the cell
+    std::unordered_map<std::size_t, std::string> m_parentNames;
+    std::unordered_map<std::size_t, std::string> m_parentStrings;
+
+    // index is the id of the cell minus m_firstId, the face is the one that created the cell
+    std::vector<frac::Face> m_cells;
+    // key is the canonical form of the cell, value is its id
+    std::unordered_map<frac::FaceKey, std::size_t, frac::FaceKeyHash> m_ids;
+    // index is the id of the cell minus m_firstId, strings are empty until they are needed
+    std::vector<std::string> m_names;
+    std::vector<std::string> m_strings;
+    // constraints of all cells, the ones of a cell are added together when it is subdivided,
+    // index is the id of the cell for the ranges, the constraints of the cell are in [first, second)
+    std::vector<frac::IncidenceConstraint> m_incidenceConstraints;
+    std::vector<frac::AdjacencyConstraint> m_adjacencyConstraints;
+    std::vector<std::pair<std::size_t, std::size_t>> m_incidenceRanges;
+    std::vector<std::pair<std::size_t, std::size_t>> m_adjacencyRanges;
+    // index is the id of the cell minus m_firstId, a deque keeps references to the subdivisions valid when cells are added
+    std::deque<std::optional<std::vector<frac::Face>>> m_subdivisions;
+    std::size_t m_subdivisionsHits = 0;
+    std::size_t m_subdivisionsMisses = 0;
+    unsigned int m_nbThreads;
+};
+
+} // frac
+
+#endif //AUTOFRAC_SUBDIVISIONCONTEXT_H
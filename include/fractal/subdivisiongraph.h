@@ -0,0 +1,50 @@
+#ifndef AUTOFRAC_SUBDIVISIONGRAPH_H
+#define AUTOFRAC_SUBDIVISIONGRAPH_H
+
+#include <vector>
+
+#include "fractal/edge.h"
+#include "fractal/face.h"
+#include "utils/set.h"
+
+namespace frac {
+
+class SubdivisionContext;
+
+// cells reachable from the roots of a structure and their subdivisions,
+// built once and not modified afterwards
+class SubdivisionGraph {
+public:
+    SubdivisionGraph(frac::SubdivisionContext& context, std::vector<frac::Face> const& roots);
+
+    // cells in closure order, roots first
+    [[nodiscard]] std::vector<frac::Face> const& cells() const;
+    [[nodiscard]] std::size_t nbCells() const;
+    [[nodiscard]] frac::Face const& cell(std::size_t index) const;
+    // index in cells() of the cell of the face
+    [[nodiscard]] std::size_t indexOf(frac::Face const& face) const;
+
+    // subdivisions of a cell are stored contiguously, from childrenBegin(index) to childrenEnd(index)
+    [[nodiscard]] std::size_t nbChildren(std::size_t index) const;
+    [[nodiscard]] frac::Face const* childrenBegin(std::size_t index) const;
+    [[nodiscard]] frac::Face const* childrenEnd(std::size_t index) const;
+    // index in cells() of the k-th subdivision of a cell
+    [[nodiscard]] std::size_t childIndex(std::size_t index, std::size_t k) const;
+
+    // edges of all cells, in order of the cells
+    [[nodiscard]] frac::Set<frac::Edge> const& edges() const;
+
+private:
+    std::vector<frac::Face> m_cells;
+    // index is the id of a cell, value is its index in m_cells
+    std::vector<std::size_t> m_indices;
+    // subdivisions of cell i are in [m_childOffsets[i], m_childOffsets[i + 1])
+    std::vector<std::size_t> m_childOffsets;
+    std::vector<frac::Face> m_children;
+    std::vector<std::size_t> m_childIndices;
+    frac::Set<frac::Edge> m_edges;
+};
+
+} // frac
+
+#endif //AUTOFRAC_SUBDIVISIONGRAPH_H
@@ -0,0 +1,33 @@
+#ifndef AUTOFRAC_SUBDIVISIONMATRICES_H
+#define AUTOFRAC_SUBDIVISIONMATRICES_H
+
+#include <array>
+#include <vector>
+#include "utils/span.h"
+
+namespace frac {
+
+// matrices cutting a bezier curve of degree Degree in n pieces, one matrix per piece written row by row
+// each set of matrices is computed once and shared by the whole program
+template<unsigned int Degree>
+class SubdivisionMatrices {
+public:
+    using Matrix = std::array<float, (Degree + 1) * (Degree + 1)>;
+
+    // matrices for n up to this value are computed at compile time, the others on first use
+    static constexpr unsigned int s_maxPrecomputed = 16;
+
+    // the n matrices of n pieces, they stay valid until the end of the program
+    static frac::Span<Matrix const> get(unsigned int n);
+};
+
+class Edge;
+
+// weights of the control points of the edge for the control points of its piece sub, one row per control point
+// of the edge and one column per control point of the piece, the same pieces as the edge states of the script,
+// degree is the one of the type of the edge
+std::vector<double> edgePieceMatrix(frac::Edge const& edge, unsigned int degree, unsigned int sub);
+
+} // frac
+
+#endif //AUTOFRAC_SUBDIVISIONMATRICES_H
@@ -0,0 +1,51 @@
+#ifndef AUTOFRAC_COORDINATESTORE_H
+#define AUTOFRAC_COORDINATESTORE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "utils/point2d.h"
+
+namespace frac {
+
+// control points of the faces of a structure, the x and the y of all the points are two arrays, face after face,
+// a point is given by its index in these arrays, the first point of a face is at first(face)
+class CoordinateStore {
+public:
+    // the indices of the placements are 32 bits
+    static constexpr std::size_t s_maxPoints = UINT32_MAX;
+
+    // adds a face of nbPoints points at the origin, returns the index of its first point
+    std::size_t addFace(std::size_t nbPoints);
+    [[nodiscard]] std::size_t nbFaces() const;
+    [[nodiscard]] bool empty() const;
+    // nb of points of all the faces
+    [[nodiscard]] std::size_t size() const;
+    [[nodiscard]] std::size_t size(std::size_t face) const;
+    [[nodiscard]] std::size_t first(std::size_t face) const;
+
+    // nb of points of the face from there
+    [[nodiscard]] float const* xs(std::size_t face) const;
+    [[nodiscard]] float const* ys(std::size_t face) const;
+    [[nodiscard]] frac::Point2D point(std::size_t index) const;
+    void set(std::size_t index, frac::Point2D const& point);
+
+    // the point target will be at t on the segment from the points prev to next, prev and next are not targets themselves
+    void addPlacement(std::size_t target, std::size_t prev, std::size_t next, float t);
+    // moves all the targets at once, then forgets the placements
+    void place();
+
+private:
+    std::vector<std::size_t> m_firsts = { 0 };
+    std::vector<float> m_xs;
+    std::vector<float> m_ys;
+    // one placement per index, kept as separate arrays so that the kernel loads them contiguously
+    std::vector<std::uint32_t> m_targets;
+    std::vector<std::uint32_t> m_prevs;
+    std::vector<std::uint32_t> m_nexts;
+    std::vector<float> m_ts;
+};
+
+} // frac
+
+#endif //AUTOFRAC_COORDINATESTORE_H
@@ -0,0 +1,34 @@
+#ifndef AUTOFRAC_FLOATFORMAT_H
+#define AUTOFRAC_FLOATFORMAT_H
+
+#include <string>
+
+namespace frac {
+
+// how floats are written in the output, independent of the locale
+struct FloatFormat {
+    enum class Mode {
+        Fixed,      // precision digits after the point
+        Shortest    // fewest digits reading back to the same float
+    };
+
+    static constexpr unsigned int s_maxPrecision = 20;
+    // enough for any float in both modes
+    static constexpr std::size_t s_maxLength = 64;
+
+    Mode mode = Mode::Fixed;
+    unsigned int precision = 4;
+
+    // writes value from first, at most s_maxLength chars, returns the end of the written chars
+    char* write(char* first, float value) const;
+    [[nodiscard]] std::string toString(float value) const;
+    // fewest digits reading back to the same double, at most s_maxLength chars
+    static char* writeShortest(char* first, double value);
+
+    // "shortest" or a number of digits, returns false if str is neither
+    static bool fromStr(std::string const& str, frac::FloatFormat& format);
+};
+
+} // frac
+
+#endif //AUTOFRAC_FLOATFORMAT_H
@@ -0,0 +1,51 @@
+#ifndef AUTOFRAC_LIBRARYINDEX_H
+#define AUTOFRAC_LIBRARYINDEX_H
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "utils/librarypack.h"
+
+namespace frac {
+
+// matrices saved in the libraries, a library is a pack file or a folder, each library and each cell is read once
+// and can be shared by the printers of several structures, from several threads
+class LibraryIndex {
+public:
+    LibraryIndex() = default;
+    LibraryIndex(LibraryIndex const& other) = delete;
+    LibraryIndex& operator=(LibraryIndex const& other) = delete;
+
+    // opens the library at libPath if it is not yet, returns false and sets error if it is a file but not a pack
+    bool open(std::string const& libPath, std::string& error);
+    // matrices of the cell with the key from LibraryPack::keyOf, nullopt if the cell is not in the library,
+    // the blob stays valid as long as the index
+    std::optional<frac::MatrixBlob> matrices(std::string const& libPath, std::string const& key);
+    // saves the blob of the cell as key.afm in the library folder, the next lookups of the cell return it,
+    // the blobs already returned for the cell stay valid, returns false and sets error if the library is a pack or the file cannot be written
+    bool save(std::string const& libPath, std::string const& key, std::string_view blob, std::string& error);
+
+private:
+    struct Library {
+        // nullptr for a folder
+        std::unique_ptr<frac::LibraryPack> pack;
+        // cells read in the folder, nullptr if a cell is not in it, the blobs never move
+        std::unordered_map<std::string, std::unique_ptr<std::string const>> cells;
+        // blobs replaced by a save, kept for the views returned before it
+        std::vector<std::unique_ptr<std::string const>> replaced;
+    };
+
+    Library* library(std::string const& libPath, std::string& error);
+
+    std::mutex m_mutex;
+    std::unordered_map<std::string, Library> m_libraries;
+};
+
+} // frac
+
+#endif //AUTOFRAC_LIBRARYINDEX_H
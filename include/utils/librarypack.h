@@ -0,0 +1,105 @@
+#ifndef AUTOFRAC_LIBRARYPACK_H
+#define AUTOFRAC_LIBRARYPACK_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "utils/mappedfile.h"
+
+namespace frac {
+
+// matrices of a cell: the nb of matrices as uint32, then for each matrix its nb of rows and of columns as uint32
+// and its float64 values row by row, all little endian, the python scripts save the same blobs in key.afm files
+class MatrixBlob {
+public:
+    static constexpr char const* s_extension = ".afm";
+
+    // nullopt if data is not exactly one blob
+    static std::optional<MatrixBlob> fromBytes(std::string_view data);
+    // a blob is built by begin then one appendMatrix per matrix, values are given row by row
+    static void begin(std::string& blob, std::uint32_t nbMatrices);
+    static void appendMatrix(std::string& blob, std::uint32_t nbRows, std::uint32_t nbColumns, double const* values);
+    // blob of matrices written as python lists of lists or numpy arrays, returns false and sets error otherwise
+    static bool fromText(std::vector<std::string> const& texts, std::string& blob, std::string& error);
+
+    [[nodiscard]] std::size_t size() const;
+    // the whole blob, as saved in a key.afm file
+    [[nodiscard]] std::string_view bytes() const;
+    [[nodiscard]] std::uint32_t nbRows(std::size_t matrix) const;
+    [[nodiscard]] std::uint32_t nbColumns(std::size_t matrix) const;
+    // values are not aligned, they are copied out of the blob
+    [[nodiscard]] double value(std::size_t matrix, std::uint32_t row, std::uint32_t column) const;
+
+private:
+    MatrixBlob() = default;
+
+    std::string_view m_data;
+    // offset of the nb of rows of each matrix
+    std::vector<std::size_t> m_offsets;
+};
+
+// pack of the matrices of a library in one file instead of a folder per cell with a text file per matrix,
+// every field is little endian: header, index of nbSlots slots, keys, then the blob of each cell aligned on 8 bytes
+class LibraryPack {
+public:
+    static constexpr char s_magic[4] = { 'A', 'F', 'L', 'P' };
+    static constexpr std::uint32_t s_version = 1;
+
+    struct Header {
+        char magic[4];
+        std::uint32_t version;
+        std::uint32_t nbSlots;
+        std::uint32_t nbEntries;
+    };
+
+    // open addressing, a key is searched from the slot hash % nbSlots, a free slot has a keyLength of 0,
+    // offsets are from the start of the file
+    struct Slot {
+        std::uint64_t hash;
+        std::uint64_t keyOffset;
+        std::uint64_t blobOffset;
+        std::uint32_t keyLength;
+        std::uint32_t blobSize;
+    };
+
+    static_assert(sizeof(Header) == 16 && sizeof(Slot) == 32, "records must not be padded");
+
+    // key is the name of the cell with '/' replaced by "--" and without spaces, as the library folders
+    struct Entry {
+        std::string key;
+        std::string blob;
+    };
+
+    LibraryPack() = default;
+    LibraryPack(LibraryPack const& other) = delete;
+    LibraryPack& operator=(LibraryPack const& other) = delete;
+
+    // FNV-1a, the same on every host
+    static std::uint64_t hash(std::string_view key);
+    // returns false and sets error if a key is empty or twice in entries, or if the file cannot be written
+    static bool write(std::string const& filename, std::vector<Entry> entries, std::string& error);
+    // key of the cell named cellName in a library
+    static std::string keyOf(std::string_view cellName);
+    // blob of the cell saved in a library folder as key.afm or as a folder key with the text files 0, 1...,
+    // nullopt if the cell is not in the folder, error is set if its files are malformed
+    static std::optional<std::string> readCell(std::string const& folderpath, std::string const& key, std::string& error);
+    // entries of a library folder, each cell is a folder with the text files 0, 1... or a key.afm blob
+    static bool readFolder(std::string const& folderpath, std::vector<Entry>& entries, std::string& error);
+
+    // maps the file, returns false and sets error if it is not a pack
+    bool open(std::string const& filename, std::string& error);
+    // blob of the cell, nullopt if the cell is not in the pack, can be called from several threads
+    [[nodiscard]] std::optional<frac::MatrixBlob> find(std::string_view key) const;
+    [[nodiscard]] std::size_t size() const;
+
+private:
+    frac::MappedFile m_file;
+    Header m_header {};
+};
+
+} // frac
+
+#endif //AUTOFRAC_LIBRARYPACK_H
@@ -0,0 +1,40 @@
+#ifndef AUTOFRAC_LIBRARYPREFETCH_H
+#define AUTOFRAC_LIBRARYPREFETCH_H
+
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "utils/libraryindex.h"
+
+namespace frac {
+
+// looks up the matrices of cells in a library on a few threads in the background,
+// so that the reads overlap what the caller does until it needs the results
+class LibraryPrefetch {
+public:
+    // the reads wait on the disk, more threads than cores do not slow them down
+    static constexpr unsigned int s_nbThreads = 4;
+
+    // starts the lookups of the keys, library must outlive the prefetch
+    LibraryPrefetch(frac::LibraryIndex& library, std::string libPath, std::vector<std::string> keys, unsigned int nbThreads = s_nbThreads);
+    // waits for the lookups
+    ~LibraryPrefetch();
+    LibraryPrefetch(LibraryPrefetch const& other) = delete;
+    LibraryPrefetch& operator=(LibraryPrefetch const& other) = delete;
+
+    // waits for the lookups, the matrices of each key are in the order of the keys
+    std::vector<std::optional<frac::MatrixBlob>> const& results();
+
+private:
+    frac::LibraryIndex& m_library;
+    std::string m_libPath;
+    std::vector<std::string> m_keys;
+    std::vector<std::optional<frac::MatrixBlob>> m_results;
+    std::thread m_thread;
+};
+
+} // frac
+
+#endif //AUTOFRAC_LIBRARYPREFETCH_H
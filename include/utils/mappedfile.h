@@ -0,0 +1,29 @@
+#ifndef AUTOFRAC_MAPPEDFILE_H
+#define AUTOFRAC_MAPPEDFILE_H
+
+#include <string>
+#include <string_view>
+
+namespace frac {
+
+// read only view on the content of a file mapped in memory
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(MappedFile const& other) = delete;
+    MappedFile& operator=(MappedFile const& other) = delete;
+
+    // returns false if the file cannot be opened or mapped, the previous mapping is released anyway
+    bool open(std::string const& filename);
+    void close();
+    [[nodiscard]] std::string_view content() const;
+
+private:
+    char const* m_data = nullptr;
+    std::size_t m_size = 0;
+};
+
+} // frac
+
+#endif //AUTOFRAC_MAPPEDFILE_H
@@ -0,0 +1,127 @@
+#ifndef AUTOFRAC_OUTPUTSINK_H
+#define AUTOFRAC_OUTPUTSINK_H
+
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "utils/floatformat.h"
+
+namespace frac {
+
+// text output going through a buffer of fixed size, the buffer is written when it is full
+// so that the memory used does not depend on the size of the output
+class OutputSink {
+public:
+    static constexpr std::size_t s_defaultBufferSize = 1 << 16;
+
+    explicit OutputSink(std::size_t bufferSize = s_defaultBufferSize);
+    virtual ~OutputSink() = default;
+    OutputSink(OutputSink const& other) = delete;
+    OutputSink& operator=(OutputSink const& other) = delete;
+
+    void append(std::string_view text);
+    void append_nl(std::string_view text);
+    // formats value directly in the buffer
+    void appendFloat(float value, frac::FloatFormat const& format);
+    // fewest digits reading back to the same double
+    void appendDouble(double value);
+    void appendInteger(unsigned long long value);
+    void appendInteger(long long value);
+
+    // writes each piece in order, pieces are texts, chars or integers, no string is built
+    template<typename... Pieces>
+    void print(Pieces const& ... pieces) {
+        (this->put(pieces), ...);
+    }
+
+    template<typename... Pieces>
+    void println(Pieces const& ... pieces) {
+        (this->put(pieces), ...);
+        this->put('\n');
+    }
+    // writes the buffer, returns false if a write failed since the sink was created
+    bool flush();
+    [[nodiscard]] bool good() const;
+
+protected:
+    // writes size chars, returns false on failure
+    virtual bool write(char const* data, std::size_t size) = 0;
+    // must be called by the destructor of derived sinks, the buffer cannot be written once they are destroyed
+    void release();
+
+private:
+    static constexpr std::size_t s_maxIntegerLength = 24;
+
+    void put(std::string_view text) {
+        this->append(text);
+    }
+
+    void put(char c);
+
+    template<typename T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, char> && !std::is_same_v<T, bool>, int> = 0>
+    void put(T value) {
+        if constexpr (std::is_signed_v<T>) {
+            this->appendInteger(static_cast<long long>(value));
+        } else {
+            this->appendInteger(static_cast<unsigned long long>(value));
+        }
+    }
+
+    // room for size chars at the end of the buffer, nullptr if the buffer is too small
+    char* reserve(std::size_t size);
+
+    std::vector<char> m_buffer;
+    std::size_t m_size = 0;
+    bool m_good = true;
+};
+
+// writes to a file, truncated when opened
+class FileSink : public OutputSink {
+public:
+    explicit FileSink(std::size_t bufferSize = s_defaultBufferSize);
+    ~FileSink() override;
+
+    // returns false if the file cannot be opened for writing
+    bool open(std::string const& filename);
+
+protected:
+    bool write(char const* data, std::size_t size) override;
+
+private:
+    std::ofstream m_file;
+};
+
+// writes to a stream that is not owned, std::cout for the standard output
+class StreamSink : public OutputSink {
+public:
+    explicit StreamSink(std::ostream& stream, std::size_t bufferSize = s_defaultBufferSize);
+    ~StreamSink() override;
+
+protected:
+    bool write(char const* data, std::size_t size) override;
+
+private:
+    std::ostream& m_stream;
+};
+
+// keeps the whole output in memory, content() is complete after flush()
+class MemorySink : public OutputSink {
+public:
+    explicit MemorySink(std::size_t bufferSize = s_defaultBufferSize);
+    ~MemorySink() override;
+
+    [[nodiscard]] std::string const& content() const;
+
+protected:
+    bool write(char const* data, std::size_t size) override;
+
+private:
+    std::string m_content;
+};
+
+} // frac
+
+#endif //AUTOFRAC_OUTPUTSINK_H
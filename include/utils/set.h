@@ -1,20 +1,28 @@
 #ifndef AUTOFRAC_SET_H
 #define AUTOFRAC_SET_H
 
-#include <algorithm>
+#include <functional>
+#include <unordered_map>
 #include <vector>
 
 namespace frac {
 
-template<typename T>
+// set that keeps the insertion order of its elements, membership is checked with the hash of the elements
+template<typename T, typename Hash = std::hash<T>>
 class Set {
 public:
     void add(T const& elt) {
-        if (std::find(this->m_data.begin(), this->m_data.end(), elt) == this->m_data.end()) {
+        std::size_t hash = this->m_hash(elt);
+        if (this->indexOf(elt, hash) == this->m_data.size()) {
+            this->m_indices.emplace(hash, this->m_data.size());
             this->m_data.emplace_back(elt);
         }
     }
 
+    bool contains(T const& elt) const {
+        return this->indexOf(elt, this->m_hash(elt)) != this->m_data.size();
+    }
+
     std::size_t size() const {
         return this->m_data.size();
     }
@@ -29,14 +37,29 @@ public:
 
     void clear() {
         this->m_data.clear();
+        this->m_indices.clear();
     }
 
-    auto begin() { return m_data.begin(); }
+    auto begin() const { return m_data.cbegin(); }
 
-    auto end() { return m_data.end(); }
+    auto end() const { return m_data.cend(); }
 
 private:
+    // index of elt in m_data, or the size of m_data if elt is not in the set
+    std::size_t indexOf(T const& elt, std::size_t hash) const {
+        auto range = this->m_indices.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (this->m_data[it->second] == elt) {
+                return it->second;
+            }
+        }
+        return this->m_data.size();
+    }
+
     std::vector<T> m_data;
+    // key is the hash of an element, value is its index in m_data
+    std::unordered_multimap<std::size_t, std::size_t> m_indices;
+    Hash m_hash;
 };
 
 } // frac
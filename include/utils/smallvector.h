@@ -0,0 +1,171 @@
+#ifndef AUTOFRAC_SMALLVECTOR_H
+#define AUTOFRAC_SMALLVECTOR_H
+
+#include <algorithm>
+#include <cstring>
+#include <initializer_list>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace frac {
+
+// vector that stores up to N elements inline and only allocates beyond,
+// elements are copied bytewise so they must be trivially copyable
+template<typename T, std::size_t N>
+class SmallVector {
+    static_assert(std::is_trivially_copyable_v<T>, "SmallVector only stores trivially copyable types");
+    static_assert(N > 0, "SmallVector needs an inline capacity");
+
+public:
+    SmallVector() = default;
+
+    SmallVector(std::initializer_list<T> init) {
+        this->assign(init.begin(), init.size());
+    }
+
+    SmallVector(SmallVector const& other) {
+        this->assign(other.m_begin, other.m_size);
+    }
+
+    SmallVector(SmallVector&& other) noexcept {
+        this->steal(other);
+    }
+
+    ~SmallVector() {
+        this->release();
+    }
+
+    SmallVector& operator=(SmallVector const& other) {
+        if (this != &other) {
+            m_size = 0;
+            this->assign(other.m_begin, other.m_size);
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) noexcept {
+        if (this != &other) {
+            this->release();
+            this->steal(other);
+        }
+        return *this;
+    }
+
+    void push_back(T const& elt) {
+        if (m_size == m_capacity) {
+            // elt may be stored in the vector itself
+            T copy = elt;
+            this->reserve(m_capacity * 2);
+            std::memcpy(static_cast<void*>(m_begin + m_size), &copy, sizeof(T));
+        } else {
+            std::memcpy(static_cast<void*>(m_begin + m_size), &elt, sizeof(T));
+        }
+        m_size++;
+    }
+
+    template<typename... Args>
+    void emplace_back(Args&& ... args) {
+        this->push_back(T(std::forward<Args>(args)...));
+    }
+
+    void reserve(std::size_t capacity) {
+        if (capacity <= m_capacity) {
+            return;
+        }
+        T* data = static_cast<T*>(::operator new(capacity * sizeof(T)));
+        if (m_size > 0) {
+            std::memcpy(static_cast<void*>(data), m_begin, m_size * sizeof(T));
+        }
+        this->release();
+        m_begin = data;
+        m_capacity = capacity;
+    }
+
+    void clear() { m_size = 0; }
+
+    std::size_t size() const { return m_size; }
+
+    bool empty() const { return m_size == 0; }
+
+    T& operator[](std::size_t index) { return m_begin[index]; }
+
+    T const& operator[](std::size_t index) const { return m_begin[index]; }
+
+    T const& at(std::size_t index) const {
+        if (index >= m_size) {
+            throw std::out_of_range("SmallVector::at");
+        }
+        return m_begin[index];
+    }
+
+    T& back() { return m_begin[m_size - 1]; }
+
+    T const& back() const { return m_begin[m_size - 1]; }
+
+    T* begin() { return m_begin; }
+
+    T* end() { return m_begin + m_size; }
+
+    T const* begin() const { return m_begin; }
+
+    T const* end() const { return m_begin + m_size; }
+
+    bool operator==(SmallVector const& other) const {
+        return m_size == other.m_size && std::equal(this->begin(), this->end(), other.begin());
+    }
+
+    bool operator!=(SmallVector const& other) const {
+        return !(*this == other);
+    }
+
+private:
+    bool isInline() const {
+        return m_begin == this->inlineData();
+    }
+
+    T* inlineData() const {
+        return reinterpret_cast<T*>(const_cast<unsigned char*>(m_inline));
+    }
+
+    void assign(T const* data, std::size_t size) {
+        this->reserve(size);
+        if (size > 0) {
+            std::memcpy(static_cast<void*>(m_begin), data, size * sizeof(T));
+        }
+        m_size = size;
+    }
+
+    // frees the heap storage if any, the vector is then inline
+    void release() {
+        if (!this->isInline()) {
+            ::operator delete(m_begin);
+        }
+        m_begin = this->inlineData();
+        m_capacity = N;
+    }
+
+    void steal(SmallVector& other) {
+        if (other.isInline()) {
+            m_size = 0;
+            this->assign(other.m_begin, other.m_size);
+        } else {
+            m_begin = other.m_begin;
+            m_size = other.m_size;
+            m_capacity = other.m_capacity;
+            other.m_begin = other.inlineData();
+            other.m_capacity = N;
+        }
+        other.m_size = 0;
+    }
+
+    alignas(T) unsigned char m_inline[N * sizeof(T)];
+    T* m_begin = this->inlineData();
+    std::size_t m_size = 0;
+    std::size_t m_capacity = N;
+};
+
+} // frac
+
+#endif //AUTOFRAC_SMALLVECTOR_H
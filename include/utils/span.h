@@ -0,0 +1,33 @@
+#ifndef AUTOFRAC_SPAN_H
+#define AUTOFRAC_SPAN_H
+
+#include <cstddef>
+
+namespace frac {
+
+// view on contiguous elements owned by someone else
+template<typename T>
+class Span {
+public:
+    Span() = default;
+
+    Span(T* begin, T* end) : m_begin(begin), m_end(end) {}
+
+    T* begin() const { return m_begin; }
+
+    T* end() const { return m_end; }
+
+    std::size_t size() const { return static_cast<std::size_t>(m_end - m_begin); }
+
+    bool empty() const { return m_begin == m_end; }
+
+    T& operator[](std::size_t index) const { return m_begin[index]; }
+
+private:
+    T* m_begin = nullptr;
+    T* m_end = nullptr;
+};
+
+} // frac
+
+#endif //AUTOFRAC_SPAN_H
@@ -4,17 +4,13 @@
 #include <algorithm>
 #include <sstream>
 #include <vector>
-#include <iomanip>
+#include "floatformat.h"
 #include "point2d.h"
 
 namespace frac::utils {
 
 inline std::string to_string(float value) {
-    std::stringstream stream;
-    stream << std::fixed << std::setprecision(4) << value;
-    std::string res = stream.str();
-    std::replace(res.begin(), res.end(), ',', '.');
-    return res;
+    return frac::FloatFormat().toString(value);
 }
 
 template<typename T>
@@ -31,6 +27,60 @@ inline T pow(T base, T up) {
     }
 }
 
+// index of the lexicographically least rotation of vec, the smallest one if several rotations are equal
+template<typename Container>
+std::size_t leastRotation(Container const& vec) {
+    std::size_t n = vec.size();
+    std::size_t i = 0;
+    std::size_t j = 1;
+    std::size_t k = 0;
+    while (i < n && j < n && k < n) {
+        auto const& a = vec[(i + k) % n];
+        auto const& b = vec[(j + k) % n];
+        if (a == b) {
+            k++;
+            continue;
+        }
+        if (b < a) {
+            i += k + 1;
+        } else {
+            j += k + 1;
+        }
+        if (i == j) {
+            j++;
+        }
+        k = 0;
+    }
+    return std::min(i, j);
+}
+
+// smallest shift that gives vec back when rotating it, vec.size() if it is not periodic
+template<typename Container>
+std::size_t rotationPeriod(Container const& vec) {
+    std::size_t n = vec.size();
+    if (n == 0) {
+        return 0;
+    }
+    // prefix function of vec
+    std::vector<std::size_t> prefix(n, 0);
+    for (std::size_t i = 1; i < n; ++i) {
+        std::size_t k = prefix[i - 1];
+        while (k > 0 && vec[i] != vec[k]) {
+            k = prefix[k - 1];
+        }
+        if (vec[i] == vec[k]) {
+            k++;
+        }
+        prefix[i] = k;
+    }
+    std::size_t period = n - prefix[n - 1];
+    return n % period == 0 ? period : n;
+}
+
+inline void hashCombine(std::size_t& seed, std::size_t value) {
+    seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+}
+
 template<typename T>
 std::vector<T> shiftVector(std::vector<T> const& vec) {
     std::vector<T> res;
@@ -63,46 +113,6 @@ inline std::vector<std::string> split(std::string const& str, std::string const&
     return strings;
 }
 
-inline std::vector<float> get_bezier_transformation(unsigned int i, unsigned int n) {
-    float denominator = static_cast<float>(n * n);
-    return { static_cast<float>((i - n) * (i - n)) / denominator,
-             static_cast<float>((i - n) * (1 + i - n)) / denominator,
-             static_cast<float>((1 + i - n) * (1 + i - n)) / denominator,
-
-             static_cast<float>(2 * i * (n - i)) / denominator,
-             static_cast<float>(n + 2 * i * n - 2 * i * (i + 1)) / denominator,
-             static_cast<float>(-2 * (1 + i - n) * (1 + i)) / denominator,
-
-             static_cast<float>(i * i) / denominator,
-             static_cast<float>(i * (1 + i)) / denominator,
-             static_cast<float>((i + 1) * (i + 1)) / denominator
-    };
-}
-
-inline std::vector<float> get_bezier_cubic_transformation(unsigned int i, unsigned int n) {
-    float denominator = static_cast<float>(n * n * n);
-    return { static_cast<float>(-(i - n) * (i - n) * (i - n)) / denominator,
-             static_cast<float>(-(i - n) * (i - n) * (i - n + 1)) / denominator,
-             static_cast<float>(-(i - n) * (i - n + 1) * (i - n + 1)) / denominator,
-             static_cast<float>(-(i - n + 1) * (i - n + 1) * (i - n + 1)) / denominator,
-
-             static_cast<float>(3 * i * (i - n) * (i - n)) / denominator,
-             static_cast<float>((i - n) * (3 * i * (i - n + 1) - n)) / denominator,
-             static_cast<float>((i - n + 1) * (3 * i * (i - n + 1) - 2 * n)) / denominator,
-             static_cast<float>(3 * (1 + i) * (i - n + 1) * (i - n + 1)) / denominator,
-
-             static_cast<float>(3 * i * i * (n - i)) / denominator,
-             static_cast<float>(i * (n * (3 * i + 2) - 3 * i * (i + 1))) / denominator,
-             static_cast<float>((i + 1) * (3 * i * n + n - 3 * i * (i + 1))) / denominator,
-             static_cast<float>(-3 * (i + 1) * (i + 1) * (i - n + 1)) / denominator,
-
-             static_cast<float>(i * i * i) / denominator,
-             static_cast<float>(i * i * (i + 1)) / denominator,
-             static_cast<float>(i * (i + 1) * (i + 1)) / denominator,
-             static_cast<float>((i + 1) * (i + 1) * (i + 1)) / denominator,
-    };
-}
-
 inline Point2D coordOfPointOnLineAt(float t, Point2D p0, Point2D p1) {
     return { p0 * (1 - t) + p1 * t };
 }
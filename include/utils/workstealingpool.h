@@ -0,0 +1,54 @@
+#ifndef AUTOFRAC_WORKSTEALINGPOOL_H
+#define AUTOFRAC_WORKSTEALINGPOOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace frac {
+
+// pool of threads running batches of indexed tasks, each thread takes the tasks
+// of its own queue and steals from the other queues when its queue is empty
+class WorkStealingPool {
+public:
+    // more threads are not started, the system may refuse them and the tasks are not that many
+    static constexpr unsigned int s_maxThreads = 256;
+
+    // the calling thread is one of the workers, so nbThreads - 1 threads are started, from 1 to s_maxThreads
+    explicit WorkStealingPool(unsigned int nbThreads);
+    ~WorkStealingPool();
+    WorkStealingPool(WorkStealingPool const& other) = delete;
+    WorkStealingPool& operator=(WorkStealingPool const& other) = delete;
+
+    // calls task(i) for each i in [0, nbTasks) and returns when every call is done
+    void run(std::size_t nbTasks, std::function<void(std::size_t)> const& task);
+    [[nodiscard]] unsigned int nbThreads() const;
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::size_t> tasks;
+    };
+
+    void loop(unsigned int index);
+    void work(unsigned int index);
+    bool takeTask(unsigned int index, std::size_t& task);
+
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread> m_threads;
+    std::function<void(std::size_t)> const* m_task = nullptr;
+    std::mutex m_mutex;
+    std::condition_variable m_batchStarted;
+    std::condition_variable m_batchDone;
+    std::size_t m_batch = 0;
+    std::size_t m_remainingTasks = 0;
+    bool m_stop = false;
+};
+
+} // frac
+
+#endif //AUTOFRAC_WORKSTEALINGPOOL_H
@@ -1,9 +1,10 @@
 #include "fractal/algorithms/algorithmsurrounddelayandbezier.h"
+#include "fractal/subdivisioncontext.h"
 #include "utils/utils.h"
 
-std::vector<frac::Face> frac::LinksSurroundDelayAndBezier::subdivide(const frac::Face& face) {
+std::vector<frac::Face> frac::LinksSurroundDelayAndBezier::subdivide(const frac::Face& face, frac::SubdivisionContext& context) {
     std::vector<frac::Face> res;
-    bool writeConstraints = Face::s_incidenceConstraints.find(face.name()) == Face::s_incidenceConstraints.end();
+    bool writeConstraints = context.incidenceConstraints(face.id()).empty();
     if (face.delay() == 0) {
         //if face has no delay
         std::vector<std::size_t> visitedDelayEdges;
@@ -19,16 +20,16 @@ std::vector<frac::Face> frac::LinksSurroundDelayAndBezier::subdivide(const frac:
                     // prev and next are bezier so merge with both of them
                     frac::Edge subCurrent { current };
                     subCurrent.decreaseDelay();
-                    std::vector<frac::Edge> boundaries = { prev, subCurrent, next };
+                    frac::EdgeList boundaries = { prev, subCurrent, next };
                     boundaries.push_back(face.adjEdge());
                     boundaries.push_back(face.gapEdge());
                     boundaries.push_back(face.adjEdge());
-                    frac::Face c = Face(boundaries, 0, face.adjEdge(), face.gapEdge(), face.reqEdge(), face.algo());
+                    frac::Face c = Face(context, boundaries, 0, face.adjEdge(), face.gapEdge(), face.reqEdge(), face.algo());
                     c.setFirstInterior(3);
                     if (writeConstraints) {
-                        Face::addIncidenceConstraint(face, c, static_cast<std::size_t>(utils::mod(static_cast<int>(i) - 1, static_cast<int>(face.len()))), prev.nbSubdivisions() - 1, 0, res.size());
-                        Face::addIncidenceConstraint(face, c, i, 0, 1, res.size());
-                        Face::addIncidenceConstraint(face, c, frac::utils::mod(i + 1, face.len()), 0, 2, res.size());
+                        context.addIncidenceConstraint(face, c, static_cast<std::size_t>(utils::mod(static_cast<int>(i) - 1, static_cast<int>(face.len()))), prev.nbSubdivisions() - 1, 0, res.size());
+                        context.addIncidenceConstraint(face, c, i, 0, 1, res.size());
+                        context.addIncidenceConstraint(face, c, frac::utils::mod(i + 1, face.len()), 0, 2, res.size());
                     }
                     res.push_back(c);
                     visitedDelayEdges.push_back(i);
@@ -36,15 +37,15 @@ std::vector<frac::Face> frac::LinksSurroundDelayAndBezier::subdivide(const frac:
                     // prev is bezier but not next so merge with prev only
                     frac::Edge subFirst { current };
                     subFirst.decreaseDelay();
-                    std::vector<frac::Edge> boundaries = { prev, subFirst };
+                    frac::EdgeList boundaries = { prev, subFirst };
                     boundaries.push_back(face.adjEdge());
                     boundaries.push_back(face.gapEdge());
                     boundaries.push_back(face.adjEdge());
-                    frac::Face c = Face(boundaries, 0, face.adjEdge(), face.gapEdge(), face.reqEdge(), face.algo());
+                    frac::Face c = Face(context, boundaries, 0, face.adjEdge(), face.gapEdge(), face.reqEdge(), face.algo());
                     c.setFirstInterior(2);
                     if (writeConstraints) {
-                        Face::addIncidenceConstraint(face, c, static_cast<std::size_t>(utils::mod(static_cast<int>(i) - 1, static_cast<int>(face.len()))), prev.nbSubdivisions() - 1, 0, res.size());
-                        Face::addIncidenceConstraint(face, c, i, 0, 1, res.size());
+                        context.addIncidenceConstraint(face, c, static_cast<std::size_t>(utils::mod(static_cast<int>(i) - 1, static_cast<int>(face.len()))), prev.nbSubdivisions() - 1, 0, res.size());
+                        context.addIncidenceConstraint(face, c, i, 0, 1, res.size());
                     }
                     res.push_back(c);
                     visitedDelayEdges.push_back(i);
@@ -52,29 +53,29 @@ std::vector<frac::Face> frac::LinksSurroundDelayAndBezier::subdivide(const frac:
                     // next is bezier but not prev so merge with next only
                     frac::Edge subFirst { current };
                     subFirst.decreaseDelay();
-                    std::vector<frac::Edge> boundaries = { subFirst, next };
+                    frac::EdgeList boundaries = { subFirst, next };
                     boundaries.push_back(face.adjEdge());
                     boundaries.push_back(face.gapEdge());
                     boundaries.push_back(face.adjEdge());
-                    frac::Face c = Face(boundaries, 0, face.adjEdge(), face.gapEdge(), face.reqEdge(), face.algo());
+                    frac::Face c = Face(context, boundaries, 0, face.adjEdge(), face.gapEdge(), face.reqEdge(), face.algo());
                     c.setFirstInterior(2);
                     if (writeConstraints) {
-                        Face::addIncidenceConstraint(face, c, i, 0, 0, res.size());
-                        Face::addIncidenceConstraint(face, c, frac::utils::mod(i + 1, face.len()), 0, 1, res.size());
+                        context.addIncidenceConstraint(face, c, i, 0, 0, res.size());
+                        context.addIncidenceConstraint(face, c, frac::utils::mod(i + 1, face.len()), 0, 1, res.size());
                     }
                     res.push_back(c);
                 } else if ((prev.edgeType() == EdgeType::CANTOR || prev.isDelay()) && (next.edgeType() == EdgeType::CANTOR || next.isDelay())) {
                     // next and prev are not bezier so no merge
                     frac::Edge subFirst { current };
                     subFirst.decreaseDelay();
-                    std::vector<frac::Edge> boundaries = { subFirst };
+                    frac::EdgeList boundaries = { subFirst };
                     boundaries.push_back(face.adjEdge());
                     boundaries.push_back(face.gapEdge());
                     boundaries.push_back(face.adjEdge());
-                    frac::Face c = Face(boundaries, 0, face.adjEdge(), face.gapEdge(), face.reqEdge(), face.algo());
+                    frac::Face c = Face(context, boundaries, 0, face.adjEdge(), face.gapEdge(), face.reqEdge(), face.algo());
                     c.setFirstInterior(1);
                     if (writeConstraints) {
-                        Face::addIncidenceConstraint(face, c, i, 0, 0, res.size());
+                        context.addIncidenceConstraint(face, c, i, 0, 0, res.size());
                     }
                     res.push_back(c);
                 }
@@ -83,7 +84,7 @@ std::vector<frac::Face> frac::LinksSurroundDelayAndBezier::subdivide(const frac:
                 std::size_t idx = static_cast<std::size_t>(utils::mod(static_cast<int>(i) - 1, static_cast<int>(face.len())));
                 if (face[idx].isDelay() && current.edgeType() == EdgeType::CANTOR) {
                     // the edge before has a delay and current edge is CANTOR, then we have not merged the edge so create a subcell for the edge's first subdivision
-                    std::vector<frac::Edge> boundaries = { current };
+                    frac::EdgeList boundaries = { current };
                     std::optional<frac::Edge> requiredEdge = face.edgeIfRequired(current);
                     if (requiredEdge.has_value()) {
                         boundaries.push_back(requiredEdge.value());
@@ -91,10 +92,10 @@ std::vector<frac::Face> frac::LinksSurroundDelayAndBezier::subdivide(const frac:
                     boundaries.push_back(face.adjEdge());
                     boundaries.push_back(face.gapEdge());
                     boundaries.push_back(face.adjEdge());
-                    frac::Face c = Face(boundaries, 0, face.adjEdge(), face.gapEdge(), face.reqEdge(), face.algo());
+                    frac::Face c = Face(context, boundaries, 0, face.adjEdge(), face.gapEdge(), face.reqEdge(), face.algo());
                     c.setFirstInterior(static_cast<int>(boundaries.size() - 3));
                     if (writeConstraints) {
-                        Face::addIncidenceConstraint(face, c, i, 0, 0, res.size());
+                        context.addIncidenceConstraint(face, c, i, 0, 0, res.size());
                     }
                     res.push_back(c);
                 }
@@ -102,7 +103,7 @@ std::vector<frac::Face> frac::LinksSurroundDelayAndBezier::subdivide(const frac:
                 // creation of intermediate subcells
                 int nbIntermediateStates { static_cast<int>(current.nbSubdivisions()) - 2 };
                 for (int j = 0; j < nbIntermediateStates; j++) {
-                    std::vector<frac::Edge> boundaries = { current };
+                    frac::EdgeList boundaries = { current };
                     std::optional<frac::Edge> requiredEdge = face.edgeIfRequired(current);
                     if (requiredEdge.has_value()) {
                         boundaries.push_back(requiredEdge.value());
@@ -114,10 +115,10 @@ std::vector<frac::Face> frac::LinksSurroundDelayAndBezier::subdivide(const frac:
                     if (requiredEdge.has_value()) {
                         boundaries.push_back(requiredEdge.value());
                     }
-                    frac::Face c = Face(boundaries, 0, face.adjEdge(), face.gapEdge(), face.reqEdge(), face.algo());
+                    frac::Face c = Face(context, boundaries, 0, face.adjEdge(), face.gapEdge(), face.reqEdge(), face.algo());
                     c.setFirstInterior(indexFirstInterior);
                     if (writeConstraints) {
-                        Face::addIncidenceConstraint(face, c, i, j + 1, 0, res.size());
+                        context.addIncidenceConstraint(face, c, i, j + 1, 0, res.size());
                     }
                     res.push_back(c);
                 }
@@ -128,7 +129,7 @@ std::vector<frac::Face> frac::LinksSurroundDelayAndBezier::subdivide(const frac:
                     // if next edge has delay
                     if (current.edgeType() == EdgeType::CANTOR) {
                         // if current edge is cantor, create a subcell only with the last current edge subdivision
-                        std::vector<frac::Edge> boundaries = { current };
+                        frac::EdgeList boundaries = { current };
                         boundaries.push_back(face.adjEdge());
                         boundaries.push_back(face.gapEdge());
                         boundaries.push_back(face.adjEdge());
@@ -136,10 +137,10 @@ std::vector<frac::Face> frac::LinksSurroundDelayAndBezier::subdivide(const frac:
                         if (requiredEdge.has_value()) {
                             boundaries.push_back(requiredEdge.value());
                         }
-                        frac::Face c = Face(boundaries, 0, face.adjEdge(), face.gapEdge(), face.reqEdge(), face.algo());
+                        frac::Face c = Face(context, boundaries, 0, face.adjEdge(), face.gapEdge(), face.reqEdge(), face.algo());
                         c.setFirstInterior(1);
                         if (writeConstraints) {
-                            Face::addIncidenceConstraint(face, c, i, nbIntermediateStates + 1, 0, res.size());
+                            context.addIncidenceConstraint(face, c, i, nbIntermediateStates + 1, 0, res.size());
                         }
                         res.push_back(c);
                     } else if (std::find(visitedDelayEdges.begin(), visitedDelayEdges.end(), utils::mod(i + 1, face.len())) == visitedDelayEdges.end()) {
@@ -156,31 +157,31 @@ std::vector<frac::Face> frac::LinksSurroundDelayAndBezier::subdivide(const frac:
                             // if next's next edge is bezier without delay, merge for the subcell
                             frac::Edge subNext { next };
                             subNext.decreaseDelay();
-                            std::vector<frac::Edge> boundaries = { current, subNext, nextNext };
+                            frac::EdgeList boundaries = { current, subNext, nextNext };
                             boundaries.push_back(face.adjEdge());
                             boundaries.push_back(face.gapEdge());
                             boundaries.push_back(face.adjEdge());
-                            frac::Face c = Face(boundaries, 0, face.adjEdge(), face.gapEdge(), face.reqEdge(), face.algo());
+                            frac::Face c = Face(context, boundaries, 0, face.adjEdge(), face.gapEdge(), face.reqEdge(), face.algo());
                             c.setFirstInterior(3);
                             if (writeConstraints) {
-                                Face::addIncidenceConstraint(face, c, i, nbIntermediateStates + 1, 0, res.size());
-                                Face::addIncidenceConstraint(face, c, frac::utils::mod(i + 1, face.len()), 0, 1, res.size());
-                                Face::addIncidenceConstraint(face, c, frac::utils::mod(i + 2, face.len()), 0, 2, res.size());
+                                context.addIncidenceConstraint(face, c, i, nbIntermediateStates + 1, 0, res.size());
+                                context.addIncidenceConstraint(face, c, frac::utils::mod(i + 1, face.len()), 0, 1, res.size());
+                                context.addIncidenceConstraint(face, c, frac::utils::mod(i + 2, face.len()), 0, 2, res.size());
                             }
                             res.push_back(c);
                         } else {
                             // next's next edge can't be merged (not bezier or delay)
                             frac::Edge subNext { next };
                             subNext.decreaseDelay();
-                            std::vector<frac::Edge> boundaries = { current, subNext };
+                            frac::EdgeList boundaries = { current, subNext };
                             boundaries.push_back(face.adjEdge());
                             boundaries.push_back(face.gapEdge());
                             boundaries.push_back(face.adjEdge());
-                            frac::Face c = Face(boundaries, 0, face.adjEdge(), face.gapEdge(), face.reqEdge(), face.algo());
+                            frac::Face c = Face(context, boundaries, 0, face.adjEdge(), face.gapEdge(), face.reqEdge(), face.algo());
                             c.setFirstInterior(2);
                             if (writeConstraints) {
-                                Face::addIncidenceConstraint(face, c, i, nbIntermediateStates + 1, 0, res.size());
-                                Face::addIncidenceConstraint(face, c, frac::utils::mod(i + 1, face.len()), 0, 1, res.size());
+                                context.addIncidenceConstraint(face, c, i, nbIntermediateStates + 1, 0, res.size());
+                                context.addIncidenceConstraint(face, c, frac::utils::mod(i + 1, face.len()), 0, 1, res.size());
                             }
                             res.push_back(c);
                         }
@@ -189,7 +190,7 @@ std::vector<frac::Face> frac::LinksSurroundDelayAndBezier::subdivide(const frac:
                     }
                 } else {
                     // if next edge has no delay, merge edges from current and next edge for the subcell
-                    std::vector<frac::Edge> boundaries = { current, next };
+                    frac::EdgeList boundaries = { current, next };
                     std::optional<frac::Edge> requiredEdge = face.edgeIfRequired(next);
                     if (requiredEdge.has_value()) {
                         boundaries.push_back(requiredEdge.value());
@@ -202,11 +203,11 @@ std::vector<frac::Face> frac::LinksSurroundDelayAndBezier::subdivide(const frac:
                     if (secondRequiredEdge.has_value()) {
                         boundaries.push_back(secondRequiredEdge.value());
                     }
-                    frac::Face c = Face(boundaries, 0, face.adjEdge(), face.gapEdge(), face.reqEdge(), face.algo());
+                    frac::Face c = Face(context, boundaries, 0, face.adjEdge(), face.gapEdge(), face.reqEdge(), face.algo());
                     c.setFirstInterior(indexFirstInterior);
                     if (writeConstraints) {
-                        Face::addIncidenceConstraint(face, c, i, nbIntermediateStates + 1, 0, res.size());
-                        Face::addIncidenceConstraint(face, c, frac::utils::mod(i + 1, face.len()), 0, 1, res.size());
+                        context.addIncidenceConstraint(face, c, i, nbIntermediateStates + 1, 0, res.size());
+                        context.addIncidenceConstraint(face, c, frac::utils::mod(i + 1, face.len()), 0, 1, res.size());
                     }
                     res.push_back(c);
                 }
@@ -216,21 +217,21 @@ std::vector<frac::Face> frac::LinksSurroundDelayAndBezier::subdivide(const frac:
             frac::Face current = res[i];
             frac::Face next = res[frac::utils::mod(i + 1, res.size())];
             if (writeConstraints) {
-                Face::addAdjacencyConstraint(face, current, next, i, current.firstInterior(), frac::utils::mod(i + 1, res.size()), next.lastInterior());
+                context.addAdjacencyConstraint(face, current, next, i, current.firstInterior(), frac::utils::mod(i + 1, res.size()), next.lastInterior());
             }
         }
     } else {
         // current face has delay
-        std::vector<frac::Edge> boundaries = {};
+        frac::EdgeList boundaries = {};
         for (std::size_t i = 0; i < face.len(); ++i) {
             // for each edge, we subdivide it and add it to the result face
             frac::Edge edge = face[i];
-            std::vector<Edge> subdivisionsEdge = edge.subdivisions(face.reqEdge());
+            frac::EdgeList subdivisionsEdge = edge.subdivisions(face.reqEdge());
             for (frac::Edge const& e: subdivisionsEdge) {
                 boundaries.push_back(e);
             }
         }
-        frac::Face c = Face(boundaries, face.delay() - 1, face.adjEdge(), face.gapEdge(), face.reqEdge(), face.algo());
+        frac::Face c = Face(context, boundaries, face.delay() - 1, face.adjEdge(), face.gapEdge(), face.reqEdge(), face.algo());
         // no adjacency constraints
         // write incidence constraints
         if (writeConstraints) {
@@ -239,7 +240,7 @@ std::vector<frac::Face> frac::LinksSurroundDelayAndBezier::subdivide(const frac:
                 frac::Edge edge { face[i] };
                 unsigned int nbSubdivisionsEdge = edge.nbActualSubdivisions();
                 for (unsigned int j = 0; j < nbSubdivisionsEdge; ++j) {
-                    Face::addIncidenceConstraint(face, c, i, j, k, 0);
+                    context.addIncidenceConstraint(face, c, i, j, k, 0);
                     if (edge.edgeType() == EdgeType::BEZIER) {
                         k++;
                     }
@@ -255,6 +256,5 @@ std::vector<frac::Face> frac::LinksSurroundDelayAndBezier::subdivide(const frac:
         }
         res.push_back(c);
     }
-    Face::s_subdivisions[face.name()] = res;
     return res;
 }
@@ -0,0 +1,74 @@
+#include "fractal/binaryformat.h"
+
+#include <cstring>
+#include <fstream>
+
+namespace {
+
+template<typename T>
+void writeRecords(std::ofstream& file, std::vector<T> const& records) {
+    file.write(reinterpret_cast<char const*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(T)));
+}
+
+} // namespace
+
+bool frac::BinaryFormat::isBinary(std::string_view content) {
+    return content.size() >= sizeof(s_magic) && std::memcmp(content.data(), s_magic, sizeof(s_magic)) == 0;
+}
+
+bool frac::BinaryFormat::isHostSupported() {
+    std::uint32_t one = 1;
+    unsigned char firstByte;
+    std::memcpy(&firstByte, &one, 1);
+    return firstByte == 1;
+}
+
+bool frac::BinaryFormat::write(std::string const& filename, std::vector<frac::Face> const& faces, std::vector<frac::Adjacency> const& adjacencies, std::vector<frac::Point2D> const& coords, std::string& error) {
+    if (!isHostSupported()) {
+        error = filename + ": the binary format needs a little endian host";
+        return false;
+    }
+    std::vector<FaceRecord> faceRecords;
+    std::vector<std::uint32_t> edges;
+    faceRecords.reserve(faces.size());
+    for (frac::Face const& f: faces) {
+        faceRecords.push_back({ static_cast<std::uint32_t>(edges.size()), static_cast<std::uint32_t>(f.len()), f.delay(), f.adjEdge().packed(), f.gapEdge().packed(), f.reqEdge().packed(), static_cast<std::uint32_t>(f.algo()) });
+        for (frac::Edge const& e: f.constData()) {
+            edges.push_back(e.packed());
+        }
+    }
+
+    std::vector<AdjacencyRecord> adjacencyRecords;
+    adjacencyRecords.reserve(adjacencies.size());
+    for (frac::Adjacency const& adj: adjacencies) {
+        adjacencyRecords.push_back({ static_cast<std::uint32_t>(adj.Face1), static_cast<std::uint32_t>(adj.Edge1), static_cast<std::uint32_t>(adj.Face2), static_cast<std::uint32_t>(adj.Edge2) });
+    }
+
+    std::vector<float> points;
+    points.reserve(2 * coords.size());
+    for (frac::Point2D const& p: coords) {
+        points.push_back(p.x());
+        points.push_back(p.y());
+    }
+
+    Header header {};
+    std::memcpy(header.magic, s_magic, sizeof(s_magic));
+    header.version = s_version;
+    header.nbFaces = static_cast<std::uint32_t>(faceRecords.size());
+    header.nbEdges = static_cast<std::uint32_t>(edges.size());
+    header.nbAdjacencies = static_cast<std::uint32_t>(adjacencyRecords.size());
+    header.nbCoords = static_cast<std::uint32_t>(coords.size());
+
+    std::ofstream file(filename, std::ofstream::out | std::ofstream::trunc | std::ofstream::binary);
+    file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+    writeRecords(file, faceRecords);
+    writeRecords(file, edges);
+    writeRecords(file, adjacencyRecords);
+    writeRecords(file, points);
+    file.close();
+    if (!file) {
+        error = filename + ": cannot write the file";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,22 @@
+#include "fractal/cellmatrices.h"
+
+frac::CellMatrices::CellMatrices(std::size_t nbCells) : m_blobs(nbCells) {}
+
+void frac::CellMatrices::set(std::size_t index, std::string blob) {
+    m_blobs[index] = std::move(blob);
+}
+
+std::optional<frac::MatrixBlob> frac::CellMatrices::matrices(std::size_t index) const {
+    if (index >= m_blobs.size() || m_blobs[index].empty()) {
+        return std::nullopt;
+    }
+    return frac::MatrixBlob::fromBytes(m_blobs[index]);
+}
+
+std::string const& frac::CellMatrices::blob(std::size_t index) const {
+    return m_blobs[index];
+}
+
+std::size_t frac::CellMatrices::size() const {
+    return m_blobs.size();
+}
@@ -0,0 +1,243 @@
+#include "fractal/chaosgame.h"
+#include "fractal/binaryformat.h"
+#include "fractal/controlpointlayout.h"
+#include "fractal/structure.h"
+#include "fractal/subdivisiongraph.h"
+#include "utils/coordinatestore.h"
+#include "utils/workstealingpool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+// random stream of a block, small and fast, seeds next to each other give independent streams
+class SplitMix64 {
+public:
+    explicit SplitMix64(std::uint64_t seed) : m_state(seed) {}
+
+    std::uint64_t operator()() {
+        std::uint64_t z = (m_state += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    std::size_t below(std::size_t n) {
+        return static_cast<std::size_t>((*this)() % n);
+    }
+
+private:
+    std::uint64_t m_state;
+};
+
+bool writeAt(int fd, void const* data, std::size_t size, std::uint64_t offset) {
+    auto const* bytes = static_cast<char const*>(data);
+    while (size > 0) {
+        ssize_t written = ::pwrite(fd, bytes, size, static_cast<off_t>(offset));
+        if (written <= 0) {
+            return false;
+        }
+        bytes += written;
+        size -= static_cast<std::size_t>(written);
+        offset += static_cast<std::uint64_t>(written);
+    }
+    return true;
+}
+
+} // namespace
+
+frac::ChaosGame::ChaosGame(frac::Structure const& structure, frac::CoordinateStore const& coords) : m_structure(structure) {
+    frac::SubdivisionGraph const& graph = structure.graph();
+    std::size_t nbCells = graph.nbCells();
+    m_sampleOffsets.push_back(0);
+    m_firstMatrices.push_back(0);
+    for (std::size_t i = 0; i < nbCells; i++) {
+        m_nbControlPoints.push_back(frac::ControlPointLayout(graph.cell(i), structure.bezierType(), structure.cantorType()).nbControlPoints());
+        m_sampleOffsets.push_back(m_sampleOffsets.back() + m_nbControlPoints.back());
+        m_firstMatrices.push_back(m_firstMatrices.back() + graph.nbChildren(i));
+    }
+    m_matrices.resize(m_firstMatrices.back());
+
+    for (std::size_t f = 0; f < structure.faces().size() && f < coords.nbFaces(); f++) {
+        m_faceCells.push_back(graph.indexOf(structure.faces()[f]));
+        std::size_t n = coords.size(f);
+        std::vector<double> controlPoints(3 * n, 1.0);
+        std::copy(coords.xs(f), coords.xs(f) + n, controlPoints.begin());
+        std::copy(coords.ys(f), coords.ys(f) + n, controlPoints.begin() + static_cast<std::ptrdiff_t>(n));
+        m_faceControlPoints.push_back(std::move(controlPoints));
+        m_faceMaps.emplace_back(graph.nbChildren(m_faceCells.back()));
+    }
+}
+
+bool frac::ChaosGame::setMatrices(std::size_t index, frac::MatrixBlob const& matrices, std::string& error) {
+    frac::SubdivisionGraph const& graph = m_structure.graph();
+    std::size_t n = m_nbControlPoints[index];
+    if (matrices.size() < graph.nbChildren(index)) {
+        error = graph.cell(index).toString() + ": " + std::to_string(matrices.size()) + " matrices for " + std::to_string(graph.nbChildren(index)) + " subdivisions";
+        return false;
+    }
+    for (std::size_t k = 0; k < graph.nbChildren(index); k++) {
+        std::size_t m = m_nbControlPoints[graph.childIndex(index, k)];
+        if (matrices.nbRows(k) != n || matrices.nbColumns(k) != m) {
+            error = graph.cell(index).toString() + ": matrix " + std::to_string(k) + " is " + std::to_string(matrices.nbRows(k)) + "x" + std::to_string(matrices.nbColumns(k))
+                    + " but " + std::to_string(n) + "x" + std::to_string(m) + " is expected";
+            return false;
+        }
+        std::vector<double>& matrix = m_matrices[m_firstMatrices[index] + k];
+        matrix.resize(n * m);
+        for (std::uint32_t row = 0; row < n; row++) {
+            for (std::uint32_t column = 0; column < m; column++) {
+                matrix[row * m + column] = matrices.value(k, row, column);
+            }
+        }
+
+        // the maps of the faces of this cell go from the points of the subdivisions to the plane
+        for (std::size_t f = 0; f < m_faceCells.size(); f++) {
+            if (m_faceCells[f] != index || m_faceControlPoints[f].size() != 3 * n) {
+                continue;
+            }
+            std::vector<double>& map = m_faceMaps[f][k];
+            map.assign(3 * m, 0.0);
+            for (std::size_t row = 0; row < 3; row++) {
+                for (std::size_t j = 0; j < n; j++) {
+                    double c = m_faceControlPoints[f][row * n + j];
+                    for (std::size_t column = 0; column < m; column++) {
+                        map[row * m + column] += c * matrix[j * m + column];
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+void frac::ChaosGame::replace(std::vector<double>& samples, std::size_t cell, std::size_t k) const {
+    std::size_t child = m_structure.graph().childIndex(cell, k);
+    std::size_t n = m_nbControlPoints[cell];
+    std::size_t m = m_nbControlPoints[child];
+    double const* matrix = m_matrices[m_firstMatrices[cell] + k].data();
+    double const* x = samples.data() + m_sampleOffsets[child];
+    double* y = samples.data() + m_sampleOffsets[cell];
+    double sum = 0.0;
+    for (std::size_t row = 0; row < n; row++) {
+        double value = 0.0;
+        for (std::size_t column = 0; column < m; column++) {
+            value += matrix[row * m + column] * x[column];
+        }
+        y[row] = value;
+        sum += value;
+    }
+    // the weights are projective, they are kept summing to 1 so that they stay bounded
+    if (sum != 0.0) {
+        for (std::size_t row = 0; row < n; row++) {
+            y[row] /= sum;
+        }
+    }
+}
+
+void frac::ChaosGame::sampleBlock(std::uint64_t block, std::uint64_t seed, std::vector<double>& samples, float* points, std::size_t nbPoints) const {
+    frac::SubdivisionGraph const& graph = m_structure.graph();
+    std::size_t nbCells = graph.nbCells();
+    SplitMix64 random(seed + block * 0x2545f4914f6cdd1dull);
+
+    // the points of the cells start at their centroid and reach their attractor by replacements,
+    // the last cells of the closure order are replaced first so that their points are used by the first ones
+    for (std::size_t i = 0; i < nbCells; i++) {
+        std::size_t n = m_nbControlPoints[i];
+        std::fill(samples.begin() + static_cast<std::ptrdiff_t>(m_sampleOffsets[i]), samples.begin() + static_cast<std::ptrdiff_t>(m_sampleOffsets[i] + n), 1.0 / static_cast<double>(n));
+    }
+    for (unsigned int sweep = 0; sweep < s_nbWarmUpSweeps; sweep++) {
+        for (std::size_t i = nbCells; i-- > 0;) {
+            if (graph.nbChildren(i) > 0) {
+                this->replace(samples, i, random.below(graph.nbChildren(i)));
+            }
+        }
+    }
+
+    std::size_t path[s_depth];
+    std::size_t subs[s_depth];
+    for (std::size_t p = 0; p < nbPoints; p++) {
+        std::size_t f = random.below(m_faceCells.size());
+        std::size_t cell = m_faceCells[f];
+        unsigned int depth = 0;
+        while (depth < s_depth && graph.nbChildren(cell) > 0) {
+            path[depth] = cell;
+            subs[depth] = random.below(graph.nbChildren(cell));
+            cell = graph.childIndex(cell, subs[depth]);
+            depth++;
+        }
+        // the points below the face are replaced from the deepest, the face itself is mapped to the plane
+        for (unsigned int d = depth; d-- > 1;) {
+            this->replace(samples, path[d], subs[d]);
+        }
+        std::size_t child = graph.childIndex(path[0], subs[0]);
+        std::size_t m = m_nbControlPoints[child];
+        double const* map = m_faceMaps[f][subs[0]].data();
+        double const* x = samples.data() + m_sampleOffsets[child];
+        double xyw[3] = { 0.0, 0.0, 0.0 };
+        for (std::size_t row = 0; row < 3; row++) {
+            for (std::size_t column = 0; column < m; column++) {
+                xyw[row] += map[row * m + column] * x[column];
+            }
+        }
+        points[2 * p] = static_cast<float>(xyw[0] / xyw[2]);
+        points[2 * p + 1] = static_cast<float>(xyw[1] / xyw[2]);
+    }
+}
+
+bool frac::ChaosGame::sample(std::string const& filename, std::uint64_t nbPoints, std::uint64_t seed, unsigned int nbThreads, std::string& error) const {
+    if (!frac::BinaryFormat::isHostSupported()) {
+        error = filename + ": the point file needs a little endian host";
+        return false;
+    }
+    for (std::size_t f = 0; f < m_faceCells.size(); f++) {
+        for (std::vector<double> const& map: m_faceMaps[f]) {
+            if (map.empty()) {
+                error = m_structure.faces()[f].toString() + ": the face has no matrices or not one coordinate per control point";
+                return false;
+            }
+        }
+    }
+    if (m_faceCells.empty()) {
+        error = filename + ": no face to sample";
+        return false;
+    }
+
+    int fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        error = filename + ": cannot open the file for writing";
+        return false;
+    }
+    Header header {};
+    std::memcpy(header.magic, s_magic, sizeof(s_magic));
+    header.version = s_version;
+    header.nbPoints = nbPoints;
+    std::atomic<bool> written { writeAt(fd, &header, sizeof(header), 0) };
+
+    // each thread takes the next block, fills it and writes it at its place in the file, without waiting for the others
+    std::uint64_t nbBlocks = (nbPoints + s_blockSize - 1) / s_blockSize;
+    std::atomic<std::uint64_t> next { 0 };
+    frac::WorkStealingPool pool(nbThreads);
+    pool.run(pool.nbThreads(), [&](std::size_t) {
+        std::vector<double> samples(m_sampleOffsets.back());
+        std::vector<float> points(2 * s_blockSize);
+        std::uint64_t block;
+        while (written && (block = next++) < nbBlocks) {
+            std::uint64_t first = block * s_blockSize;
+            auto nbBlockPoints = static_cast<std::size_t>(std::min(s_blockSize, nbPoints - first));
+            this->sampleBlock(block, seed, samples, points.data(), nbBlockPoints);
+            if (!writeAt(fd, points.data(), 2 * nbBlockPoints * sizeof(float), sizeof(Header) + 2 * first * sizeof(float))) {
+                written = false;
+            }
+        }
+    });
+    if (::close(fd) != 0 || !written) {
+        error = filename + ": cannot write the file";
+        return false;
+    }
+    return true;
+}
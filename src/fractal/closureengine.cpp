@@ -0,0 +1,66 @@
+#include "fractal/closureengine.h"
+#include "fractal/subdivisioncontext.h"
+
+#include <memory>
+
+frac::ClosureEngine::ClosureEngine(frac::SubdivisionContext& context) : m_context(context), m_pool(context.nbThreads()) {}
+
+frac::Set<frac::Face> frac::ClosureEngine::closure(std::vector<frac::Face> const& roots) {
+    frac::Set<frac::Face> res;
+    for (frac::Face const& f: roots) {
+        res.add(f);
+    }
+    for (frac::Face const& root: roots) {
+        frac::Set<frac::Face> faces;
+        faces.add(root);
+        std::size_t i = 0;
+        bool changed = true;
+        while (changed) {
+            frac::Set<frac::Face> added;
+            for (std::vector<frac::Face> const* subs: this->subdivisionsFrom(faces, i)) {
+                for (frac::Face const& f: *subs) {
+                    added.add(f);
+                }
+            }
+            std::size_t lastSize = faces.size();
+            for (frac::Face const& f: added.data()) {
+                faces.add(f);
+            }
+            changed = faces.size() != lastSize;
+            i = lastSize;
+        }
+        for (frac::Face const& f: faces.data()) {
+            res.add(f);
+        }
+    }
+    return res;
+}
+
+std::vector<std::vector<frac::Face> const*> frac::ClosureEngine::subdivisionsFrom(frac::Set<frac::Face> const& faces, std::size_t first) {
+    std::vector<std::size_t> toStage;
+    for (std::size_t j = first; j < faces.size(); ++j) {
+        if (!m_context.hasSubdivisions(faces[j].id())) {
+            toStage.push_back(faces[j].id());
+        }
+    }
+
+    // the context is only read while staging
+    std::vector<std::unique_ptr<frac::SubdivisionContext>> staged(toStage.size());
+    m_pool.run(toStage.size(), [&](std::size_t k) {
+        staged[k] = m_context.stageSubdivisions(toStage[k]);
+    });
+
+    // commit in the order a serial traversal would have subdivided the cells
+    std::vector<std::vector<frac::Face> const*> res;
+    std::size_t k = 0;
+    for (std::size_t j = first; j < faces.size(); ++j) {
+        if (k < toStage.size() && faces[j].id() == toStage[k]) {
+            res.push_back(&m_context.commitSubdivisions(toStage[k], *staged[k]));
+            staged[k].reset();
+            k++;
+        } else {
+            res.push_back(&m_context.subdivisions(faces[j].id()));
+        }
+    }
+    return res;
+}
@@ -0,0 +1,10 @@
+#include "fractal/constraint.h"
+#include "utils/outputsink.h"
+
+void frac::IncidenceConstraint::print(frac::OutputSink& output, std::string_view cellName) const {
+    output.println("    ", cellName, "(Bord('", bord, "') + Sub('", sub, "'), Sub('", subFace, "') + Bord('", subFaceBord, "'))");
+}
+
+void frac::AdjacencyConstraint::print(frac::OutputSink& output, std::string_view cellName) const {
+    output.println("    ", cellName, "(Sub('", sub1, "') + Bord('", bord1, "') + Permut('", permut, "'), Sub('", sub2, "') + Bord('", bord2, "'))");
+}
@@ -0,0 +1,228 @@
+#include "fractal/constraintsolver.h"
+#include "fractal/controlpointlayout.h"
+#include "fractal/structure.h"
+#include "fractal/subdivisiongraph.h"
+#include "fractal/subdivisionmatrices.h"
+#include "utils/workstealingpool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+namespace {
+
+double dot(std::vector<double> const& a, std::vector<double> const& b) {
+    double res = 0.0;
+    for (std::size_t i = 0; i < a.size(); i++) {
+        res += a[i] * b[i];
+    }
+    return res;
+}
+
+double maxAbs(std::vector<double> const& a) {
+    double res = 0.0;
+    for (double value: a) {
+        res = std::max(res, std::abs(value));
+    }
+    return res;
+}
+
+} // namespace
+
+void frac::ConstraintSolver::System::addEquation(std::size_t column1, double value1, std::size_t column2, double value2, double value) {
+    columns.push_back(column1);
+    values.push_back(value1);
+    if (value2 != 0.0) {
+        columns.push_back(column2);
+        values.push_back(value2);
+    }
+    rowOffsets.push_back(columns.size());
+    rhs.push_back(value);
+}
+
+std::size_t frac::ConstraintSolver::System::nbRows() const {
+    return rhs.size();
+}
+
+void frac::ConstraintSolver::System::multiply(std::vector<double> const& x, std::vector<double>& res) const {
+    res.assign(this->nbRows(), 0.0);
+    for (std::size_t row = 0; row < this->nbRows(); row++) {
+        for (std::size_t e = rowOffsets[row]; e < rowOffsets[row + 1]; e++) {
+            res[row] += values[e] * x[columns[e]];
+        }
+    }
+}
+
+void frac::ConstraintSolver::System::multiplyTransposed(std::vector<double> const& y, std::vector<double>& res) const {
+    std::fill(res.begin(), res.end(), 0.0);
+    for (std::size_t row = 0; row < this->nbRows(); row++) {
+        for (std::size_t e = rowOffsets[row]; e < rowOffsets[row + 1]; e++) {
+            res[columns[e]] += values[e] * y[row];
+        }
+    }
+}
+
+frac::ConstraintSolver::ConstraintSolver(frac::Structure const& structure) : m_structure(structure) {}
+
+bool frac::ConstraintSolver::solve(frac::CellMatrices const& initial, unsigned int nbThreads, std::string& error) {
+    frac::SubdivisionGraph const& graph = m_structure.graph();
+    std::size_t nbCells = graph.nbCells();
+    for (std::size_t i = 0; i < nbCells; i++) {
+        if (!initial.matrices(i).has_value()) {
+            error = graph.cell(i).toString() + ": no initial matrices to solve the constraints from";
+            return false;
+        }
+    }
+    m_matrices = frac::CellMatrices(nbCells);
+    m_residuals.assign(nbCells, 0.0);
+    m_nbIterations.assign(nbCells, 0);
+
+    // the cells share no variable, each one is solved on its own
+    std::mutex errorMutex;
+    bool failed = false;
+    frac::WorkStealingPool pool(nbThreads);
+    pool.run(nbCells, [&](std::size_t i) {
+        std::string blob;
+        std::string cellError;
+        if (this->solveCell(i, initial.matrices(i).value(), blob, cellError, m_residuals[i], m_nbIterations[i])) {
+            m_matrices.set(i, std::move(blob));
+        } else {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!failed) {
+                failed = true;
+                error = cellError;
+            }
+        }
+    });
+    return !failed;
+}
+
+frac::CellMatrices const& frac::ConstraintSolver::matrices() const {
+    return m_matrices;
+}
+
+double frac::ConstraintSolver::residual() const {
+    return m_residuals.empty() ? 0.0 : *std::max_element(m_residuals.begin(), m_residuals.end());
+}
+
+unsigned int frac::ConstraintSolver::nbIterations() const {
+    return m_nbIterations.empty() ? 0 : *std::max_element(m_nbIterations.begin(), m_nbIterations.end());
+}
+
+bool frac::ConstraintSolver::solveCell(std::size_t index, frac::MatrixBlob const& initial, std::string& blob, std::string& error, double& residual, unsigned int& nbIterations) const {
+    frac::SubdivisionGraph const& graph = m_structure.graph();
+    frac::Face const& cell = graph.cell(index);
+    frac::BezierType bezierType = m_structure.bezierType();
+    frac::CantorType cantorType = m_structure.cantorType();
+    frac::ControlPointLayout cellLayout(cell, bezierType, cantorType);
+    std::size_t n = cellLayout.nbControlPoints();
+
+    // entry (r, c) of the matrix of subdivision k is the variable firsts[k] + r * nbColumns[k] + c,
+    // the edges of the constraints are counted from the first edge of the cell of the subdivision
+    std::vector<frac::ControlPointLayout> layouts;
+    std::vector<std::size_t> nbColumns;
+    std::vector<std::size_t> firsts = { 0 };
+    for (std::size_t k = 0; k < graph.nbChildren(index); k++) {
+        layouts.emplace_back(graph.cell(graph.childIndex(index, k)), bezierType, cantorType);
+        nbColumns.push_back(layouts.back().nbControlPoints());
+        firsts.push_back(firsts.back() + n * nbColumns.back());
+    }
+    if (initial.size() < layouts.size()) {
+        error = cell.toString() + ": " + std::to_string(initial.size()) + " initial matrices for " + std::to_string(layouts.size()) + " subdivisions";
+        return false;
+    }
+    std::vector<double> x(firsts.back());
+    for (std::size_t k = 0; k < layouts.size(); k++) {
+        if (initial.nbRows(k) != n || initial.nbColumns(k) != nbColumns[k]) {
+            error = cell.toString() + ": initial matrix " + std::to_string(k) + " is " + std::to_string(initial.nbRows(k)) + "x" + std::to_string(initial.nbColumns(k))
+                    + " but " + std::to_string(n) + "x" + std::to_string(nbColumns[k]) + " is expected";
+            return false;
+        }
+        for (std::uint32_t r = 0; r < n; r++) {
+            for (std::uint32_t c = 0; c < nbColumns[k]; c++) {
+                x[firsts[k] + r * nbColumns[k] + c] = initial.value(k, r, c);
+            }
+        }
+    }
+
+    System system;
+    // cell(Bord(bord) + Sub(sub), Sub(subFace) + Bord(subFaceBord)): the columns of the control points of the edge
+    // of the subdivision are the control points of the edge of the cell times the matrix of the piece of the edge
+    for (frac::IncidenceConstraint const& c: m_structure.context().incidenceConstraints(cell.id())) {
+        frac::Edge const& edge = cell[c.bord];
+        unsigned int degree = edge.edgeType() == frac::EdgeType::CANTOR ? frac::degree(cantorType) : frac::degree(bezierType);
+        std::vector<double> piece = frac::edgePieceMatrix(edge, degree, c.sub);
+        std::vector<std::size_t> cellPoints = cellLayout.controlPointIndices(c.bord);
+        std::vector<std::size_t> subPoints = layouts[c.subFace].controlPointIndices(c.subFaceBord);
+        for (std::size_t r = 0; r < n; r++) {
+            for (std::size_t q = 0; q <= degree && q < subPoints.size(); q++) {
+                double value = 0.0;
+                for (std::size_t p = 0; p <= degree && p < cellPoints.size(); p++) {
+                    if (cellPoints[p] == r) {
+                        value += piece[p * (degree + 1) + q];
+                    }
+                }
+                system.addEquation(firsts[c.subFace] + r * nbColumns[c.subFace] + subPoints[q], 1.0, 0, 0.0, value);
+            }
+        }
+    }
+    // cell(Sub(sub1) + Bord(bord1) + Permut(permut), Sub(sub2) + Bord(bord2)): the reversed edge of a subdivision is the edge of the other
+    for (frac::AdjacencyConstraint const& c: m_structure.context().adjacencyConstraints(cell.id())) {
+        std::vector<std::size_t> first = layouts[c.sub1].controlPointIndices(c.bord1);
+        std::vector<std::size_t> second = layouts[c.sub2].controlPointIndices(c.bord2, true);
+        for (std::size_t r = 0; r < n; r++) {
+            for (std::size_t q = 0; q < first.size() && q < second.size(); q++) {
+                system.addEquation(firsts[c.sub1] + r * nbColumns[c.sub1] + first[q], 1.0, firsts[c.sub2] + r * nbColumns[c.sub2] + second[q], -1.0, 0.0);
+            }
+        }
+    }
+
+    // conjugate gradients on A At y = b - A x0
+    std::vector<double> res;
+    system.multiply(x, res);
+    std::vector<double> rest(system.nbRows());
+    for (std::size_t row = 0; row < system.nbRows(); row++) {
+        rest[row] = system.rhs[row] - res[row];
+    }
+    std::vector<double> y(system.nbRows(), 0.0);
+    std::vector<double> direction = rest;
+    std::vector<double> atDirection(x.size());
+    std::vector<double> aatDirection;
+    double restNorm = dot(rest, rest);
+    nbIterations = 0;
+    while (maxAbs(rest) > s_tolerance && nbIterations < s_maxIterations) {
+        nbIterations++;
+        system.multiplyTransposed(direction, atDirection);
+        system.multiply(atDirection, aatDirection);
+        double curvature = dot(direction, aatDirection);
+        if (curvature <= 0.0) {
+            break;
+        }
+        double step = restNorm / curvature;
+        for (std::size_t row = 0; row < system.nbRows(); row++) {
+            y[row] += step * direction[row];
+            rest[row] -= step * aatDirection[row];
+        }
+        double nextNorm = dot(rest, rest);
+        for (std::size_t row = 0; row < system.nbRows(); row++) {
+            direction[row] = rest[row] + nextNorm / restNorm * direction[row];
+        }
+        restNorm = nextNorm;
+    }
+    std::vector<double> correction(x.size());
+    system.multiplyTransposed(y, correction);
+    for (std::size_t v = 0; v < x.size(); v++) {
+        x[v] += correction[v];
+    }
+    system.multiply(x, res);
+    residual = 0.0;
+    for (std::size_t row = 0; row < system.nbRows(); row++) {
+        residual = std::max(residual, std::abs(res[row] - system.rhs[row]));
+    }
+
+    frac::MatrixBlob::begin(blob, static_cast<std::uint32_t>(layouts.size()));
+    for (std::size_t k = 0; k < layouts.size(); k++) {
+        frac::MatrixBlob::appendMatrix(blob, static_cast<std::uint32_t>(n), static_cast<std::uint32_t>(nbColumns[k]), x.data() + firsts[k]);
+    }
+    return true;
+}
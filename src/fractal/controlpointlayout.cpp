@@ -0,0 +1,57 @@
+#include "fractal/controlpointlayout.h"
+
+#include <algorithm>
+
+frac::ControlPointLayout::ControlPointLayout(frac::Face const& face, frac::BezierType bezierType, frac::CantorType cantorType) {
+    m_firstControlPoints.reserve(face.len() + 1);
+    m_firstControlPoints.push_back(0);
+    for (frac::Edge const& e: face.constData()) {
+        //the last control point of an edge is the first one of the next edge
+        m_firstControlPoints.push_back(m_firstControlPoints.back() + e.nbControlPoints(bezierType, cantorType) - 1);
+    }
+
+    m_internControlPoints.assign(this->nbControlPoints(), true);
+    for (std::size_t i = 0; i < face.len(); i++) {
+        m_internControlPoints[m_firstControlPoints[i]] = false;
+    }
+}
+
+std::size_t frac::ControlPointLayout::nbControlPoints() const {
+    return m_firstControlPoints.back();
+}
+
+std::size_t frac::ControlPointLayout::nbEdges() const {
+    return m_firstControlPoints.size() - 1;
+}
+
+std::size_t frac::ControlPointLayout::firstControlPoint(std::size_t indexEdge) const {
+    return m_firstControlPoints[indexEdge];
+}
+
+std::size_t frac::ControlPointLayout::nbInternControlPoints(std::size_t indexEdge) const {
+    return m_firstControlPoints[indexEdge + 1] - m_firstControlPoints[indexEdge] - 1;
+}
+
+bool frac::ControlPointLayout::isInternControlPoint(std::size_t indexControlPoint) const {
+    return indexControlPoint < m_internControlPoints.size() && m_internControlPoints[indexControlPoint];
+}
+
+bool frac::ControlPointLayout::isControlPointBelongEdge(std::size_t indexControlPoint, std::size_t indexEdge) const {
+    std::size_t first = m_firstControlPoints[indexEdge];
+    std::size_t last = m_firstControlPoints[indexEdge + 1];
+    return (indexControlPoint >= first && indexControlPoint < last) || indexControlPoint == last % this->nbControlPoints();
+}
+
+std::vector<std::size_t> frac::ControlPointLayout::controlPointIndices(std::size_t indexEdge, bool reverse) const {
+    std::vector<std::size_t> res;
+    std::size_t first = m_firstControlPoints[indexEdge];
+    std::size_t last = m_firstControlPoints[indexEdge + 1];
+    res.reserve(last - first + 1);
+    for (std::size_t i = first; i <= last; i++) {
+        res.push_back(i % this->nbControlPoints());
+    }
+    if (reverse) {
+        std::reverse(res.begin(), res.end());
+    }
+    return res;
+}
@@ -1,7 +1,18 @@
 #include "fractal/edge.h"
 #include "utils/utils.h"
 
-frac::Edge::Edge(EdgeType edgeType, unsigned int nbSubdivisions, unsigned int delay) : m_edgeType(edgeType), m_nbSubdivisions(nbSubdivisions), m_delay(delay) {}
+#include <stdexcept>
+
+frac::Edge::Edge(EdgeType edgeType, unsigned int nbSubdivisions, unsigned int delay) :
+        m_packed((static_cast<std::uint32_t>(edgeType) << s_typeShift) | (nbSubdivisions << s_nbSubdivisionsShift) | delay) {
+    // a masked value would be another edge
+    if (nbSubdivisions > s_maxNbSubdivisions) {
+        throw std::out_of_range("Edge: more than " + std::to_string(s_maxNbSubdivisions) + " subdivisions");
+    }
+    if (delay > s_maxDelay) {
+        throw std::out_of_range("Edge: delay above " + std::to_string(s_maxDelay));
+    }
+}
 
 frac::Edge frac::Edge::fromStr(const std::string& name) {
     std::vector<std::string> splitEdgeName = frac::utils::split(name, '_');
@@ -13,30 +24,34 @@ frac::Edge frac::Edge::fromStr(const std::string& name) {
     return { type, nbSubs, delayEdge };
 }
 
+frac::Edge frac::Edge::fromPacked(std::uint32_t packed) {
+    return { static_cast<frac::EdgeType>(packed >> s_typeShift), (packed >> s_nbSubdivisionsShift) & s_nbSubdivisionsMask, packed & s_delayMask };
+}
+
 void frac::Edge::decreaseDelay() {
     if (this->isDelay()) {
-        m_delay--;
+        m_packed--;
     }
 }
 
 frac::EdgeType frac::Edge::edgeType() const {
-    return m_edgeType;
+    return static_cast<frac::EdgeType>(m_packed >> s_typeShift);
 }
 
 unsigned int frac::Edge::nbActualSubdivisions() const {
-    return this->isDelay() ? 1 : m_nbSubdivisions;
+    return this->isDelay() ? 1 : this->nbSubdivisions();
 }
 
 unsigned int frac::Edge::nbSubdivisions() const {
-    return m_nbSubdivisions;
+    return (m_packed >> s_nbSubdivisionsShift) & s_nbSubdivisionsMask;
 }
 
 unsigned int frac::Edge::delay() const {
-    return m_delay;
+    return m_packed & s_delayMask;
 }
 
-std::vector<frac::Edge> frac::Edge::subdivisions(Edge const& reqEdge) const {
-    std::vector<Edge> result;
+frac::EdgeList frac::Edge::subdivisions(Edge const& reqEdge) const {
+    frac::EdgeList result;
     if (this->isDelay()) {
         result.emplace_back(this->edgeType(), this->nbSubdivisions(), this->delay() - 1);
     } else {
@@ -58,7 +73,7 @@ std::vector<frac::Edge> frac::Edge::subdivisions(Edge const& reqEdge) const {
 }
 
 bool frac::Edge::isDelay() const {
-    return m_delay > 0;
+    return (m_packed & s_delayMask) > 0;
 }
 
 namespace frac {
@@ -72,13 +87,25 @@ std::ostream& operator<<(std::ostream& os, frac::Edge const& edge) {
 }
 
 bool frac::Edge::operator==(Edge const& other) const {
-    return m_edgeType == other.m_edgeType && m_delay == other.m_delay && m_nbSubdivisions == other.m_nbSubdivisions;
+    return m_packed == other.m_packed;
 }
 
 bool frac::Edge::operator!=(Edge const& other) const {
     return !(*this == other);
 }
 
+bool frac::Edge::operator<(Edge const& other) const {
+    return m_packed < other.m_packed;
+}
+
+std::size_t frac::Edge::hash() const {
+    return m_packed;
+}
+
+std::uint32_t frac::Edge::packed() const {
+    return m_packed;
+}
+
 std::string frac::Edge::toString() const {
     std::string res;
 
@@ -100,61 +127,22 @@ std::string frac::Edge::name() const {
 }
 
 void frac::Edge::setEdgeType(frac::EdgeType edgeType) {
-    m_edgeType = edgeType;
+    *this = { edgeType, this->nbSubdivisions(), this->delay() };
 }
 
 void frac::Edge::setNbSubdivisions(unsigned int nbSubdivisions) {
-    m_nbSubdivisions = nbSubdivisions;
+    *this = { this->edgeType(), nbSubdivisions, this->delay() };
 }
 
 void frac::Edge::setDelay(unsigned int delay) {
-    m_delay = delay;
+    *this = { this->edgeType(), this->nbSubdivisions(), delay };
 }
 
 std::size_t frac::Edge::nbControlPoints(frac::BezierType bezierType, frac::CantorType cantorType) const {
-    switch (this->edgeType()) {
-        case EdgeType::CANTOR:
-            switch (cantorType) {
-                case CantorType::Classic_Cantor:
-                    return 2;
-                case CantorType::Quadratic_Cantor:
-                    return 3;
-                case CantorType::Cubic_Cantor:
-                    return 4;
-            }
-            break;
-        case EdgeType::BEZIER:
-            switch (bezierType) {
-                case BezierType::Quadratic_Bezier:
-                    return 3;
-                case BezierType::Cubic_Bezier:
-                    return 4;
-            }
-    }
-    //to avoid warning, but may not be executed
-    return 0;
+    return this->nbInternControlPoints(bezierType, cantorType) + 2;
 }
 
 std::size_t frac::Edge::nbInternControlPoints(frac::BezierType bezierType, frac::CantorType cantorType) const {
-    switch (this->edgeType()) {
-        case EdgeType::CANTOR:
-            switch (cantorType) {
-                case CantorType::Classic_Cantor:
-                    return 0;
-                case CantorType::Quadratic_Cantor:
-                    return 1;
-                case CantorType::Cubic_Cantor:
-                    return 2;
-            }
-            break;
-        case EdgeType::BEZIER:
-            switch (bezierType) {
-                case BezierType::Quadratic_Bezier:
-                    return 1;
-                case BezierType::Cubic_Bezier:
-                    return 2;
-            }
-    }
-    //to avoid warning, but may not be executed
-    return 0;
+    // a curve of degree d has d + 1 control points, both ends are vertices
+    return (this->edgeType() == EdgeType::CANTOR ? frac::degree(cantorType) : frac::degree(bezierType)) - 1;
 }
@@ -0,0 +1,24 @@
+#include "fractal/edgestateemitter.h"
+
+#include <utility>
+
+namespace {
+
+// emitters of the degrees First, First + 1, ... First + sizeof...(Offsets) - 1
+template<template<unsigned int> class Emitter, unsigned int First, unsigned int... Offsets>
+constexpr std::array<frac::EdgeStateEmitters, sizeof...(Offsets)> emittersOfDegrees(std::integer_sequence<unsigned int, Offsets...>) {
+    return { frac::EdgeStateEmitters::of<Emitter<First + Offsets>>()... };
+}
+
+constexpr auto s_bezierEmitters = emittersOfDegrees<frac::BezierEmitter, 2>(std::make_integer_sequence<unsigned int, frac::s_maxDegree - 1>());
+constexpr auto s_cantorEmitters = emittersOfDegrees<frac::CantorEmitter, 1>(std::make_integer_sequence<unsigned int, frac::s_maxDegree>());
+
+}
+
+frac::EdgeStateEmitters frac::bezierEmitters(frac::BezierType bezierType) {
+    return s_bezierEmitters[frac::degree(bezierType) - 2];
+}
+
+frac::EdgeStateEmitters frac::cantorEmitters(frac::CantorType cantorType) {
+    return s_cantorEmitters[frac::degree(cantorType) - 1];
+}
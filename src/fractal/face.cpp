@@ -1,45 +1,34 @@
 #include "fractal/face.h"
+#include "fractal/closureengine.h"
+#include "fractal/subdivisioncontext.h"
 #include "utils/utils.h"
-#include "fractal/algorithms/algorithmsurrounddelayandbezier.h"
-#include "fractal/algorithms/algorithmsurrounddelay.h"
-#include "fractal/algorithms/algorithmoncorners.h"
 
 #include <iostream>
 
-frac::Set<frac::Face> frac::Face::s_existingFaces;
-std::map<std::string, std::string> frac::Face::s_incidenceConstraints;
-std::map<std::string, std::string> frac::Face::s_adjacencyConstraints;
-std::unordered_map<std::string, std::vector<frac::Face>> frac::Face::s_subdivisions;
-
-frac::Face::Face(std::vector<Edge> edges, unsigned int delay, frac::Edge const& adjEdge, frac::Edge const& gapEdge, frac::Edge const& reqEdge, AlgorithmSubdivision algo) :
-        m_data(std::move(edges)), m_delay(delay), m_adjEdge(adjEdge), m_gapEdge(gapEdge), m_reqEdge(reqEdge), m_offset(0), m_firstInterior(-1), m_algo(algo) {
-    for (Face const& f: s_existingFaces.data()) {
-        if (*this == f) {
-            m_name = f.m_name;
-            m_offset = computeOffset(f, *this);
+frac::Face::Face(frac::SubdivisionContext& context, frac::EdgeList edges, unsigned int delay, frac::Edge const& adjEdge, frac::Edge const& gapEdge, frac::Edge const& reqEdge, AlgorithmSubdivision algo) :
+        m_context(&context), m_data(std::move(edges)), m_delay(delay), m_adjEdge(adjEdge), m_gapEdge(gapEdge), m_reqEdge(reqEdge), m_id(0), m_offset(0), m_rotation(frac::utils::leastRotation(m_data)), m_firstInterior(-1), m_algo(algo) {
+    frac::FaceKey key = this->key();
+    std::optional<std::size_t> id = context.findCell(key);
+    if (id.has_value()) {
+        Face const& f = context.cell(id.value());
+        m_id = f.m_id;
+        // both faces start at the same least rotation, so the offset is the difference
+        // of their rotations, modulo the period of the edges for symmetric faces
+        std::size_t period = frac::utils::rotationPeriod(key.edges);
+        if (period > 0) {
+            m_offset = (m_rotation + period - f.m_rotation % period) % period;
         }
+    } else {
+        //if face doesn't exist
+        m_id = context.nbCells();
+        context.addCell(std::move(key), *this);
     }
-    //if face doesn't exist
-    if (m_name.empty()) {
-        m_name = "Cell_" + std::to_string(s_existingFaces.size());
-        if (m_delay != 0) {
-            // one face if delayed, with subdivided boundaries
-            // add delay info to name
-            m_name += "_" + std::to_string(delay);
-        }
-        s_existingFaces.add(*this);
-    }
-}
-
-std::vector<frac::Edge> const& frac::Face::constData() const {
-    return m_data;
 }
 
-std::vector<frac::Edge>& frac::Face::data() {
+frac::EdgeList const& frac::Face::constData() const {
     return m_data;
 }
 
-
 int frac::Face::firstInterior() const {
     return m_firstInterior;
 }
@@ -52,8 +41,12 @@ std::size_t frac::Face::len() const {
     return m_data.size();
 }
 
-std::string frac::Face::name() const {
-    return m_name;
+std::size_t frac::Face::id() const {
+    return m_id;
+}
+
+std::string const& frac::Face::name() const {
+    return m_context->cellName(m_id);
 }
 
 std::size_t frac::Face::offset() const {
@@ -64,23 +57,8 @@ void frac::Face::setFirstInterior(int index) {
     m_firstInterior = index;
 }
 
-void frac::Face::setAlgo(frac::AlgorithmSubdivision algo) {
-    m_algo = algo;
-}
-
-std::vector<frac::Face> frac::Face::subdivisions() const {
-    if (s_subdivisions.find(m_name) != s_subdivisions.end()) {
-        return s_subdivisions[m_name];
-    }
-    switch (m_algo) {
-        case AlgorithmSubdivision::LinksSurroundDelay:
-            return frac::LinksSurroundDelay::subdivide(*this);
-        case AlgorithmSubdivision::LinksSurroundDelayAndBezier:
-            return frac::LinksSurroundDelayAndBezier::subdivide(*this);
-        case AlgorithmSubdivision::LinksOnCorners:
-            return frac::LinksOnCorners::subdivide(*this);
-    }
-    return {};
+std::vector<frac::Face> const& frac::Face::subdivisions() const {
+    return m_context->subdivisions(m_id);
 }
 
 const frac::Edge& frac::Face::operator[](std::size_t index) const {
@@ -88,23 +66,8 @@ const frac::Edge& frac::Face::operator[](std::size_t index) const {
 }
 
 bool frac::Face::operator==(frac::Face const& other) const {
-    if (m_delay != other.m_delay || this->len() != other.len() || m_adjEdge != other.m_adjEdge || m_gapEdge != other.m_gapEdge || m_reqEdge != other.m_reqEdge || m_algo != other.m_algo) {
-        return false;
-    }
-
-    std::vector<frac::Edge> shifted { other.m_data };
-
-    for (std::size_t i = 0; i < this->len(); ++i) {
-        if (m_data == shifted) {
-            return true;
-        }
-        std::vector<frac::Edge> new_shifted { frac::utils::shiftVector(shifted) };
-        shifted.clear();
-        for (Edge const& e: new_shifted) {
-            shifted.emplace_back(e);
-        }
-    }
-    return false;
+    // faces are interned, equal faces whatever their rotation have the same id
+    return m_id == other.m_id;
 }
 
 namespace frac {
@@ -113,77 +76,47 @@ std::ostream& operator<<(std::ostream& os, frac::Face const& face) {
 }
 }
 
-void frac::Face::addAdjacencyConstraint(frac::Face const& face, frac::Face const& faceSub1, frac::Face const& faceSub2, unsigned int indexSubFace1, unsigned int indexBordFace1, unsigned int indexSubFace2, unsigned int indexBordFace2) {
-    if (s_adjacencyConstraints.find(face.name()) == std::end(Face::s_adjacencyConstraints)) {
-        s_adjacencyConstraints[face.name()] = "";
+frac::FaceKey frac::Face::key() const {
+    frac::EdgeList edges;
+    edges.reserve(this->len());
+    for (std::size_t i = 0; i < this->len(); ++i) {
+        edges.push_back(m_data[(m_rotation + i) % this->len()]);
     }
-    int s1 = static_cast<int>(indexSubFace1);
-    int b1 = frac::utils::mod(static_cast<int>(indexBordFace1) - static_cast<int>(faceSub1.offset()), static_cast<int>(faceSub1.len()));
-    int s2 = static_cast<int>(indexSubFace2);
-    int b2 = frac::utils::mod(static_cast<int>(indexBordFace2) - static_cast<int>(faceSub2.offset()), static_cast<int>(faceSub2.len()));
-    s_adjacencyConstraints[face.name()] += "    " + face.name() + "(Sub('" + std::to_string(s1) + "') + Bord('" + std::to_string(b1) + "') + Permut('0'), Sub('" + std::to_string(s2) + "') + Bord('" + std::to_string(b2) + "'))\n";
+    return { edges, m_delay, m_adjEdge, m_gapEdge, m_reqEdge, m_algo };
 }
 
-void frac::Face::addIncidenceConstraint(frac::Face const& face, frac::Face const& faceSub, unsigned int indexParentEdge, unsigned int indexSubEdge, unsigned int indexSubFaceEdge, unsigned int indexSubFace) {
-    if (s_incidenceConstraints.find(face.name()) == std::end(Face::s_incidenceConstraints)) {
-        s_incidenceConstraints[face.name()] = "";
-    }
-    int b1 = frac::utils::mod(static_cast<int>(indexParentEdge) - static_cast<int>(face.offset()), static_cast<int>(face.len()));
-    int s1 = static_cast<int>(indexSubEdge);
-    int s2 = static_cast<int>(indexSubFace);
-    int b2 = frac::utils::mod(static_cast<int>(indexSubFaceEdge) - static_cast<int>(faceSub.offset()), static_cast<int>(faceSub.len()));
-    s_incidenceConstraints[face.name()] += "    " + face.name() + "(Bord('" + std::to_string(b1) + "') + Sub('" + std::to_string(s1) + "'), Sub('" + std::to_string(s2) + "') + Bord('" + std::to_string(b2) + "'))\n";
+bool frac::FaceKey::operator==(frac::FaceKey const& other) const {
+    return delay == other.delay && adjEdge == other.adjEdge && gapEdge == other.gapEdge && reqEdge == other.reqEdge && algo == other.algo && edges == other.edges;
 }
 
-std::size_t frac::Face::computeOffset(frac::Face const& face, frac::Face const& other) {
-    std::vector<Edge> shifted { other.m_data };
-    for (std::size_t i = 0; i < other.len(); ++i) {
-        if (face.m_data == shifted) {
-            return i;
-        }
-        shifted = frac::utils::shiftVector(shifted);
+std::size_t frac::FaceKeyHash::operator()(frac::FaceKey const& key) const {
+    std::size_t res = key.edges.size();
+    for (frac::Edge const& e: key.edges) {
+        frac::utils::hashCombine(res, e.hash());
     }
-    return 0;
+    frac::utils::hashCombine(res, key.delay);
+    frac::utils::hashCombine(res, key.adjEdge.hash());
+    frac::utils::hashCombine(res, key.gapEdge.hash());
+    frac::utils::hashCombine(res, key.reqEdge.hash());
+    frac::utils::hashCombine(res, static_cast<std::size_t>(key.algo));
+    return res;
 }
 
-frac::Set<frac::Face> frac::Face::allSubdivisions() const {
-    frac::Set<frac::Face> res;
-    res.add(*this);
-    std::size_t i = 0;
-    bool changed = true;
-    while (changed) {
-        frac::Set<frac::Face> added;
-        for (std::size_t j = i; j < res.size(); ++j) {
-            std::vector<frac::Face> subs = res[j].subdivisions();
-            for (frac::Face const& f: subs) {
-                added.add(f);
-            }
-        }
-        std::size_t lastSize = res.size();
-        for (frac::Face const& f: added.data()) {
-            res.add(f);
-        }
-        changed = res.size() != lastSize;
-        i = lastSize;
-    }
-    return res;
+std::size_t frac::Face::hash() const {
+    return std::hash<std::size_t> {}(m_id);
 }
 
-std::string frac::Face::toString() const {
-    std::string res = (*this)[0].toString();
-    for (std::size_t i = 1; i < this->len(); ++i) {
-        res += " - " + (*this)[i].toString();
-    }
-    res += " / ";
+frac::Set<frac::Face> frac::Face::allSubdivisions() const {
+    return frac::ClosureEngine(*m_context).closure({ *this });
+}
 
-    res += m_adjEdge.toString() + " - ";
-    res += m_gapEdge.toString() + " - ";
-    res += m_reqEdge.toString() + " / ";
-    res += std::to_string(m_delay) + " / ";
-    res += std::to_string(static_cast<int>(m_algo));
-    return res;
+std::string const& frac::Face::toString() const {
+    return m_context->cellString(m_id);
 }
 
+frac::SubdivisionContext& frac::Face::context() const {
+    return *m_context;
+}
 
 frac::Edge frac::Face::adjEdge() const {
     return m_adjEdge;
@@ -197,29 +130,6 @@ frac::Edge frac::Face::reqEdge() const {
     return m_reqEdge;
 }
 
-void frac::Face::reset() {
-    Face::s_incidenceConstraints.clear();
-    Face::s_adjacencyConstraints.clear();
-    Face::s_existingFaces.clear();
-    Face::s_subdivisions.clear();
-}
-
-void frac::Face::setAdjEdge(frac::Edge const& edge) {
-    m_adjEdge = edge;
-}
-
-void frac::Face::setGapEdge(frac::Edge const& edge) {
-    m_gapEdge = edge;
-}
-
-void frac::Face::setReqEdge(frac::Edge const& edge) {
-    m_reqEdge = edge;
-}
-
-void frac::Face::setDelay(unsigned int delay) {
-    m_delay = delay;
-}
-
 unsigned int frac::Face::delay() const {
     return m_delay;
 }
@@ -245,7 +155,7 @@ std::size_t frac::Face::nbControlPoints(BezierType bezierType, CantorType cantor
     return res;
 }
 
-frac::Face frac::Face::fromStr(std::string const& name) {
+frac::Face frac::Face::fromStr(frac::SubdivisionContext& context, std::string const& name) {
     std::string sepCellInfo = " / ";
     std::string sepEdges = " - ";
 
@@ -254,7 +164,7 @@ frac::Face frac::Face::fromStr(std::string const& name) {
     std::string const& paramsNames = splitCellName[1];
     unsigned int delay = std::stoul(splitCellName[2]);
 
-    std::vector<frac::Edge> edges;
+    frac::EdgeList edges;
     for (std::string const& edgeName: frac::utils::split(edgesNames, sepEdges)) {
         edges.emplace_back(frac::Edge::fromStr(edgeName));
     }
@@ -265,5 +175,5 @@ frac::Face frac::Face::fromStr(std::string const& name) {
     frac::Edge reqEdge = frac::Edge::fromStr(splitParamsNames[2]);
 
     frac::AlgorithmSubdivision algo = static_cast<frac::AlgorithmSubdivision>(std::stoul(splitCellName[3]));
-    return frac::Face(edges, delay, adjEdge, gapEdge, reqEdge, algo);
+    return frac::Face(context, edges, delay, adjEdge, gapEdge, reqEdge, algo);
 }
@@ -0,0 +1,344 @@
+#include "fractal/inputreader.h"
+#include "fractal/binaryformat.h"
+#include "fractal/subdivisioncontext.h"
+#include "utils/mappedfile.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+
+namespace {
+
+enum class Section {
+    Faces,
+    Constraints,
+    Coords
+};
+
+bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+std::string_view trim(std::string_view str) {
+    while (!str.empty() && isBlank(str.front())) {
+        str.remove_prefix(1);
+    }
+    while (!str.empty() && isBlank(str.back())) {
+        str.remove_suffix(1);
+    }
+    return str;
+}
+
+// removes the text up to the next separator from str and returns it trimmed, str then starts after the separator
+std::string_view nextToken(std::string_view& str, char separator) {
+    std::size_t end = str.find(separator);
+    std::string_view token = str.substr(0, end);
+    str.remove_prefix(end == std::string_view::npos ? str.size() : end + 1);
+    return trim(token);
+}
+
+// nb of tokens nextToken gives for str
+std::size_t nbTokens(std::string_view str, char separator) {
+    std::size_t res = 1;
+    for (char c: str) {
+        if (c == separator) {
+            res++;
+        }
+    }
+    return res;
+}
+
+} // namespace
+
+frac::InputReader::InputReader(frac::SubdivisionContext& context) : m_context(context) {}
+
+bool frac::InputReader::read(std::string const& filename) {
+    frac::MappedFile file;
+    if (!file.open(filename)) {
+        m_error = filename + ": cannot read the file";
+        return false;
+    }
+    if (frac::BinaryFormat::isBinary(file.content())) {
+        return this->parseBinary(file.content(), filename);
+    }
+    return this->parse(file.content(), filename);
+}
+
+bool frac::InputReader::parseBinary(std::string_view content, std::string const& filename) {
+    using namespace frac::BinaryFormat;
+    m_filename = filename;
+    auto fail = [this](std::string const& message) {
+        m_error = m_filename + ": " + message;
+        return false;
+    };
+
+    Header header {};
+    if (!isBinary(content) || content.size() < sizeof(Header)) {
+        return fail("not a binary structure file");
+    }
+    if (!isHostSupported()) {
+        return fail("the binary format needs a little endian host");
+    }
+    std::memcpy(&header, content.data(), sizeof(Header));
+    if (header.version != s_version) {
+        return fail("unsupported version " + std::to_string(header.version) + ", expected " + std::to_string(s_version));
+    }
+    std::size_t expectedSize = sizeof(Header) + std::size_t { header.nbFaces } * sizeof(FaceRecord) + std::size_t { header.nbEdges } * sizeof(std::uint32_t) + std::size_t { header.nbAdjacencies } * sizeof(AdjacencyRecord) + std::size_t { header.nbCoords } * 2 * sizeof(float);
+    if (content.size() != expectedSize) {
+        return fail("size is " + std::to_string(content.size()) + " bytes but the header describes " + std::to_string(expectedSize) + " bytes");
+    }
+
+    char const* faceTable = content.data() + sizeof(Header);
+    char const* edgeTable = faceTable + std::size_t { header.nbFaces } * sizeof(FaceRecord);
+    char const* adjacencyTable = edgeTable + std::size_t { header.nbEdges } * sizeof(std::uint32_t);
+    char const* coordBlock = adjacencyTable + std::size_t { header.nbAdjacencies } * sizeof(AdjacencyRecord);
+
+    m_faces.reserve(m_faces.size() + header.nbFaces);
+    for (std::size_t i = 0; i < header.nbFaces; i++) {
+        FaceRecord record {};
+        std::memcpy(&record, faceTable + i * sizeof(FaceRecord), sizeof(FaceRecord));
+        if (record.nbEdges == 0 || record.firstEdge > header.nbEdges || record.nbEdges > header.nbEdges - record.firstEdge) {
+            return fail("face " + std::to_string(i) + " has edges out of the edge table");
+        }
+        if (record.algo > static_cast<std::uint32_t>(frac::AlgorithmSubdivision::LinksOnCorners)) {
+            return fail("face " + std::to_string(i) + " has an unknown subdivision algorithm");
+        }
+        frac::EdgeList edges;
+        edges.reserve(record.nbEdges);
+        for (std::size_t j = 0; j < record.nbEdges; j++) {
+            std::uint32_t packed;
+            std::memcpy(&packed, edgeTable + (record.firstEdge + j) * sizeof(std::uint32_t), sizeof(std::uint32_t));
+            edges.push_back(frac::Edge::fromPacked(packed));
+        }
+        frac::Edge params[3] = { frac::Edge::fromPacked(record.adjEdge), frac::Edge::fromPacked(record.gapEdge), frac::Edge::fromPacked(record.reqEdge) };
+        // the fields of a packed word are always in range, an edge without subdivisions is rejected as in the text
+        bool valid = std::all_of(edges.begin(), edges.end(), [](frac::Edge const& e) { return e.nbSubdivisions() > 0; })
+                     && std::all_of(std::begin(params), std::end(params), [](frac::Edge const& e) { return e.nbSubdivisions() > 0; });
+        if (!valid) {
+            return fail("face " + std::to_string(i) + " has an edge without subdivisions");
+        }
+        m_faces.emplace_back(m_context, edges, record.delay, params[0], params[1], params[2], static_cast<frac::AlgorithmSubdivision>(record.algo));
+    }
+
+    m_constraints.reserve(m_constraints.size() + header.nbAdjacencies);
+    for (std::size_t i = 0; i < header.nbAdjacencies; i++) {
+        AdjacencyRecord record {};
+        std::memcpy(&record, adjacencyTable + i * sizeof(AdjacencyRecord), sizeof(AdjacencyRecord));
+        if (record.face1 >= m_faces.size() || record.face2 >= m_faces.size() || record.edge1 >= m_faces[record.face1].len() || record.edge2 >= m_faces[record.face2].len()) {
+            return fail("adjacency " + std::to_string(i) + " refers to a face or an edge that does not exist");
+        }
+        m_constraints.emplace_back(record.face1, record.edge1, record.face2, record.edge2);
+    }
+
+    // points are two floats, as the coordinate block
+    static_assert(sizeof(frac::Point2D) == 2 * sizeof(float) && std::is_trivially_copyable_v<frac::Point2D>, "Point2D must be two floats");
+    std::size_t first = m_coords.size();
+    m_coords.resize(first + header.nbCoords);
+    std::memcpy(static_cast<void*>(m_coords.data() + first), coordBlock, std::size_t { header.nbCoords } * sizeof(frac::Point2D));
+    return true;
+}
+
+bool frac::InputReader::parse(std::string_view content, std::string const& filename) {
+    m_filename = filename;
+    m_lineNumber = 0;
+    Section section = Section::Faces;
+    while (!content.empty()) {
+        std::size_t end = content.find('\n');
+        m_line = content.substr(0, end);
+        content.remove_prefix(end == std::string_view::npos ? content.size() : end + 1);
+        m_lineNumber++;
+
+        std::string_view line = trim(m_line);
+        if (line.empty() || line.front() == '#') {
+            continue;
+        }
+        if (line.front() == 'f') {
+            section = Section::Faces;
+            continue;
+        }
+        if (line.front() == 'c') {
+            section = Section::Constraints;
+            continue;
+        }
+        if (line.front() == 'p') {
+            section = Section::Coords;
+            continue;
+        }
+
+        bool ok = false;
+        switch (section) {
+            case Section::Faces:
+                ok = this->parseFace(line);
+                break;
+            case Section::Constraints:
+                ok = this->parseConstraint(line);
+                break;
+            case Section::Coords:
+                ok = this->parseCoord(line);
+                break;
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool frac::InputReader::parseFace(std::string_view line) {
+    if (nbTokens(line, '/') != 4) {
+        return this->fail(line, "expected 'edges / adjacent - gap - required edges / delay / algorithm'");
+    }
+    std::string_view edgesNames = nextToken(line, '/');
+    std::string_view paramsNames = nextToken(line, '/');
+    std::string_view delayName = nextToken(line, '/');
+    std::string_view algoName = nextToken(line, '/');
+
+    frac::EdgeList edges;
+    while (!edgesNames.empty()) {
+        frac::Edge edge { frac::EdgeType::BEZIER, 2 };
+        if (!this->parseEdge(nextToken(edgesNames, '-'), edge)) {
+            return false;
+        }
+        edges.push_back(edge);
+    }
+    if (edges.empty()) {
+        return this->fail(edgesNames, "a face needs at least one edge");
+    }
+
+    if (nbTokens(paramsNames, '-') != 3) {
+        return this->fail(paramsNames, "expected 3 edges: adjacent - gap - required");
+    }
+    frac::Edge params[3] = {{ frac::EdgeType::CANTOR, 2 }, { frac::EdgeType::BEZIER, 2 }, { frac::EdgeType::BEZIER, 2 }};
+    for (frac::Edge& e: params) {
+        if (!this->parseEdge(nextToken(paramsNames, '-'), e)) {
+            return false;
+        }
+    }
+
+    unsigned int delay = 0;
+    if (!this->parseUnsigned(delayName, delay)) {
+        return false;
+    }
+    unsigned int algo = 0;
+    if (!this->parseUnsigned(algoName, algo)) {
+        return false;
+    }
+    if (algo > static_cast<unsigned int>(frac::AlgorithmSubdivision::LinksOnCorners)) {
+        return this->fail(algoName, "unknown subdivision algorithm");
+    }
+
+    m_faces.emplace_back(m_context, edges, delay, params[0], params[1], params[2], static_cast<frac::AlgorithmSubdivision>(algo));
+    return true;
+}
+
+bool frac::InputReader::parseConstraint(std::string_view line) {
+    if (nbTokens(line, '/') != 2) {
+        return this->fail(line, "expected 'face.edge / face.edge'");
+    }
+    std::size_t indices[4];
+    for (std::size_t i = 0; i < 2; i++) {
+        std::string_view faceEdge = nextToken(line, '/');
+        if (nbTokens(faceEdge, '.') != 2) {
+            return this->fail(faceEdge, "expected 'face.edge'");
+        }
+        std::string_view faceName = nextToken(faceEdge, '.');
+        std::string_view edgeName = nextToken(faceEdge, '.');
+        unsigned int face = 0;
+        unsigned int edge = 0;
+        if (!this->parseUnsigned(faceName, face) || !this->parseUnsigned(edgeName, edge)) {
+            return false;
+        }
+        if (face >= m_faces.size()) {
+            return this->fail(faceName, "no face " + std::to_string(face) + " before this line");
+        }
+        if (edge >= m_faces[face].len()) {
+            return this->fail(edgeName, "face " + std::to_string(face) + " has no edge " + std::to_string(edge));
+        }
+        indices[2 * i] = face;
+        indices[2 * i + 1] = edge;
+    }
+    m_constraints.emplace_back(indices[0], indices[1], indices[2], indices[3]);
+    return true;
+}
+
+bool frac::InputReader::parseCoord(std::string_view line) {
+    float values[2];
+    char const* current = line.data();
+    char const* end = line.data() + line.size();
+    for (float& value: values) {
+        while (current != end && isBlank(*current)) {
+            current++;
+        }
+        std::from_chars_result result = std::from_chars(current, end, value);
+        if (result.ec != std::errc()) {
+            return this->fail({ current, static_cast<std::size_t>(end - current) }, "expected a number");
+        }
+        current = result.ptr;
+    }
+    if (current != end) {
+        return this->fail({ current, static_cast<std::size_t>(end - current) }, "expected 2 coordinates");
+    }
+    m_coords.emplace_back(values[0], values[1]);
+    return true;
+}
+
+bool frac::InputReader::parseEdge(std::string_view token, frac::Edge& edge) {
+    std::string_view name = token;
+    if (nbTokens(name, '_') != 3) {
+        return this->fail(token, "expected an edge 'type_subdivisions_delay'");
+    }
+    std::string_view typeName = nextToken(name, '_');
+    if (typeName != "C" && typeName != "B") {
+        return this->fail(typeName, "edge type must be C or B");
+    }
+    std::string_view nbSubsName = nextToken(name, '_');
+    std::string_view delayName = nextToken(name, '_');
+    unsigned int nbSubs = 0;
+    unsigned int delay = 0;
+    if (!this->parseUnsigned(nbSubsName, nbSubs) || !this->parseUnsigned(delayName, delay)) {
+        return false;
+    }
+    if (nbSubs == 0 || nbSubs > frac::Edge::s_maxNbSubdivisions) {
+        return this->fail(nbSubsName, "nb of subdivisions must be from 1 to " + std::to_string(frac::Edge::s_maxNbSubdivisions));
+    }
+    if (delay > frac::Edge::s_maxDelay) {
+        return this->fail(delayName, "delay must be at most " + std::to_string(frac::Edge::s_maxDelay));
+    }
+    edge = { typeName == "C" ? frac::EdgeType::CANTOR : frac::EdgeType::BEZIER, nbSubs, delay };
+    return true;
+}
+
+bool frac::InputReader::parseUnsigned(std::string_view token, unsigned int& value) {
+    std::from_chars_result result = std::from_chars(token.data(), token.data() + token.size(), value);
+    if (token.empty() || result.ec != std::errc() || result.ptr != token.data() + token.size()) {
+        return this->fail(token, "expected a non negative integer");
+    }
+    return true;
+}
+
+bool frac::InputReader::fail(std::string_view token, std::string const& message) {
+    std::size_t column = 1;
+    if (token.data() >= m_line.data() && token.data() <= m_line.data() + m_line.size()) {
+        column += static_cast<std::size_t>(token.data() - m_line.data());
+    }
+    m_error = m_filename + ":" + std::to_string(m_lineNumber) + ":" + std::to_string(column) + ": " + message;
+    return false;
+}
+
+std::vector<frac::Face> const& frac::InputReader::faces() const {
+    return m_faces;
+}
+
+std::vector<frac::Adjacency> const& frac::InputReader::constraints() const {
+    return m_constraints;
+}
+
+std::vector<frac::Point2D> const& frac::InputReader::coords() const {
+    return m_coords;
+}
+
+std::string const& frac::InputReader::error() const {
+    return m_error;
+}
@@ -0,0 +1,327 @@
+#include "fractal/job.h"
+#include "fractal/chaosgame.h"
+#include "fractal/constraintsolver.h"
+#include "fractal/controlpointlayout.h"
+#include "fractal/inputreader.h"
+#include "fractal/springmasssolver.h"
+#include "fractal/structure.h"
+#include "fractal/structureprinter.h"
+#include "fractal/subdivisioncontext.h"
+#include "fractal/subdivisiongraph.h"
+#include "utils/coordinatestore.h"
+#include "utils/outputsink.h"
+#include "utils/point2d.h"
+#include "utils/workstealingpool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <sstream>
+
+frac::JobResult frac::runJob(frac::JobOptions const& options, frac::LibraryIndex& library, std::ostream& log) {
+    JobResult result;
+    auto start = std::chrono::steady_clock::now();
+    auto fail = [&](std::string const& error) {
+        result.error = error;
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return result;
+    };
+
+    frac::SubdivisionContext context;
+    if (options.nbThreads != 0) {
+        context.setNbThreads(options.nbThreads);
+    }
+    frac::InputReader reader(context);
+    if (!reader.read(options.input)) {
+        return fail(reader.error());
+    }
+    std::vector<frac::Face> const& faces = reader.faces();
+    std::vector<frac::Adjacency> const& constraints = reader.constraints();
+    std::vector<frac::Point2D> const& readCoords = reader.coords();
+    frac::CoordinateStore coords;
+
+    for (frac::Face const& f: faces) {
+        log << f.name() << std::endl;
+    }
+
+    frac::Structure structure(context, faces, static_cast<frac::BezierType>(options.bezierDegree), static_cast<frac::CantorType>(options.cantorDegree));
+    for (frac::Adjacency const& adj: constraints) {
+        structure.addAdjacency(adj);
+    }
+
+    //check there are enough coordinates, one per vertex and one per intern control point if not auto
+    std::size_t nbExpectedCoords = 0;
+    for (frac::Face const& f: faces) {
+        for (frac::Edge const& e: f.constData()) {
+            nbExpectedCoords += (e.edgeType() == frac::EdgeType::BEZIER && !options.autoCoord) ? options.bezierDegree : 1;
+        }
+    }
+    if (readCoords.size() < nbExpectedCoords) {
+        return fail(options.input + ": " + std::to_string(readCoords.size()) + " coordinates but " + std::to_string(nbExpectedCoords) + " expected");
+    }
+
+    if (readCoords.size() > frac::CoordinateStore::s_maxPoints) {
+        return fail(options.input + ": more than " + std::to_string(frac::CoordinateStore::s_maxPoints) + " coordinates");
+    }
+
+    //fill coordinates, the control points of a face are stored from the edge at its offset, as the ones of its cell,
+    //the intern control points that are not read are placed evenly spaced on the segment between the ends of their edge
+    std::size_t currentReadCoord = 0;
+    for (std::size_t i = 0; i < faces.size(); i++) {
+        frac::ControlPointLayout const& layout = structure.layout(i);
+        std::size_t nbCtrlPts = layout.nbControlPoints();
+        std::size_t first = coords.addFace(nbCtrlPts);
+        // index in the face of the next control point read, the ones of the edges before the offset go to the end
+        std::size_t current = nbCtrlPts == 0 ? 0 : (nbCtrlPts - layout.firstControlPoint(faces[i].offset()) % nbCtrlPts) % nbCtrlPts;
+        for (std::size_t e = 0; e < layout.nbEdges(); e++) {
+            std::size_t vertex = first + current;
+            coords.set(vertex, readCoords[currentReadCoord]);
+            currentReadCoord++;
+            std::size_t nbIntern = layout.nbInternControlPoints(e);
+            // the intern control points of cantor edges are not in the input
+            bool readIntern = faces[i][e].edgeType() == frac::EdgeType::BEZIER && !options.autoCoord;
+            std::size_t end = (current + nbIntern + 1) % nbCtrlPts;
+            for (std::size_t k = 1; k <= nbIntern; k++) {
+                current = current + 1 == nbCtrlPts ? 0 : current + 1;
+                if (readIntern) {
+                    coords.set(first + current, readCoords[currentReadCoord]);
+                    currentReadCoord++;
+                } else {
+                    coords.addPlacement(first + current, vertex, first + end, static_cast<float>(k) / static_cast<float>(nbIntern + 1));
+                }
+            }
+            current = end;
+        }
+    }
+    coords.place();
+
+    std::string libraryError;
+    if (!library.open(options.libraryPath, libraryError)) {
+        return fail(libraryError);
+    }
+
+    frac::SubdivisionGraph const& graph = structure.graph();
+    frac::SpringMassSolver solver(structure);
+    if (options.solveSubs || options.solveConstraints) {
+        solver.solve(context.nbThreads());
+        log << "Spring–mass system: " << solver.nbIterations() << " iterations, " << solver.nbUnconverged() << " cells not converged" << std::endl;
+    }
+
+    frac::ConstraintSolver constraintSolver(structure);
+    if (options.solveConstraints) {
+        // the matrices of the library are the start of the solve, the spring–mass solver gives the ones of the other cells
+        frac::CellMatrices initial(graph.nbCells());
+        for (std::size_t i = 0; i < graph.nbCells(); i++) {
+            std::optional<frac::MatrixBlob> matrices = library.matrices(options.libraryPath, frac::LibraryPack::keyOf(graph.cell(i).toString()));
+            // the scripts save one matrix less than the nb of subdivisions, such cells start from the spring–mass solver
+            bool complete = matrices.has_value() && matrices->size() >= graph.nbChildren(i);
+            initial.set(i, complete ? std::string(matrices->bytes()) : solver.matrices().blob(i));
+        }
+        std::string error;
+        if (!constraintSolver.solve(initial, context.nbThreads(), error)) {
+            return fail(error);
+        }
+        log << "Constraints: " << constraintSolver.nbIterations() << " iterations, residual " << constraintSolver.residual() << std::endl;
+        result.constraintsResidual = constraintSolver.residual();
+        for (std::size_t i = 0; i < graph.nbCells(); i++) {
+            if (!library.save(options.libraryPath, frac::LibraryPack::keyOf(graph.cell(i).toString()), constraintSolver.matrices().blob(i), error)) {
+                // the script still gets the solved matrices
+                log << error << ", the solved matrices are not saved" << std::endl;
+                break;
+            }
+        }
+    }
+
+    if (options.nbPoints != 0) {
+        if (options.output == "-") {
+            return fail("the points cannot be written to the standard output");
+        }
+        frac::ChaosGame game(structure, coords);
+        std::string error;
+        for (std::size_t i = 0; i < graph.nbCells(); i++) {
+            std::optional<frac::MatrixBlob> matrices;
+            if (options.solveConstraints) {
+                matrices = constraintSolver.matrices().matrices(i);
+            } else {
+                matrices = library.matrices(options.libraryPath, frac::LibraryPack::keyOf(graph.cell(i).toString()));
+            }
+            // the scripts save one matrix less than the nb of subdivisions, such cells are taken from the spring–mass solver
+            bool complete = matrices.has_value() && matrices->size() >= graph.nbChildren(i);
+            if (!complete && options.solveSubs) {
+                matrices = solver.matrices().matrices(i);
+            } else if (!complete) {
+                return fail(graph.cell(i).toString() + ": the cell is not in the library " + options.libraryPath + " or misses matrices, -s or -x solves it");
+            }
+            if (!game.setMatrices(i, matrices.value(), error)) {
+                return fail(error);
+            }
+        }
+        if (!game.sample(options.output, options.nbPoints, frac::ChaosGame::s_defaultSeed, context.nbThreads(), error)) {
+            return fail(error);
+        }
+        log << options.nbPoints << " points of the attractor written to file " << options.output << std::endl;
+
+        result.success = true;
+        result.nbCellStates = graph.nbCells();
+        result.nbEdgeStates = graph.edges().size();
+        result.nbPoints = options.nbPoints;
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return result;
+    }
+
+    std::unique_ptr<frac::OutputSink> output;
+    if (options.output == "-") {
+        output = std::make_unique<frac::StreamSink>(std::cout);
+    } else {
+        auto file = std::make_unique<frac::FileSink>();
+        if (!file->open(options.output)) {
+            return fail(options.output + ": cannot open the file for writing");
+        }
+        output = std::move(file);
+    }
+    frac::StructurePrinter printer(structure, true, *output, options.nbIterAutoSubs, options.libraryPath, &coords, &library);
+    printer.setFloatFormat(options.floatFormat);
+    if (options.solveSubs) {
+        printer.setFallbackMatrices(&solver.matrices());
+    }
+    if (options.solveConstraints) {
+        printer.setSolvedMatrices(&constraintSolver.matrices());
+    }
+    printer.exportStruct();
+    if (!output->good()) {
+        return fail(options.output + ": cannot write the output");
+    }
+    log << "Subdivisions cache: " << context.subdivisionsHits() << " hits, " << context.subdivisionsMisses() << " misses" << std::endl;
+    if (options.output == "-") {
+        log << "Structure exported to the standard output" << std::endl;
+    } else {
+        log << "Structure exported to file " << options.output << std::endl;
+    }
+
+    result.success = true;
+    result.nbCellStates = graph.nbCells();
+    result.nbEdgeStates = graph.edges().size();
+    result.subdivisionsHits = context.subdivisionsHits();
+    result.subdivisionsMisses = context.subdivisionsMisses();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+bool frac::readManifest(std::string const& filename, std::vector<frac::JobOptions>& jobs, std::string& error) {
+    std::ifstream file(filename);
+    if (!file) {
+        error = filename + ": cannot read the file";
+        return false;
+    }
+    std::string line;
+    std::size_t lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        std::istringstream words(line);
+        std::vector<std::string> args;
+        std::string word;
+        while (words >> word) {
+            args.push_back(word);
+        }
+        if (args.empty() || args[0][0] == '#') {
+            continue;
+        }
+        auto fail = [&](std::string const& message) {
+            error = filename + ":" + std::to_string(lineNumber) + ": " + message;
+            return false;
+        };
+        if (args.size() < 2) {
+            return fail("expected 'input output [options]'");
+        }
+
+        JobOptions job;
+        job.input = args[0];
+        job.output = args[1];
+        if (job.output == "-") {
+            // the outputs of jobs running together would be mixed
+            return fail("the output of a job cannot be the standard output");
+        }
+        // jobs already run in parallel
+        job.nbThreads = 1;
+        for (std::size_t i = 2; i < args.size(); i++) {
+            std::string const& option = args[i];
+            bool hasValue = i + 1 < args.size();
+            if (option == "-a") {
+                job.autoCoord = true;
+            } else if (option == "-s") {
+                job.solveSubs = true;
+            } else if (option == "-x") {
+                job.solveConstraints = true;
+            } else if (option == "-c") {
+                job.bezierDegree = 3;
+            } else if (option == "-d" && hasValue) {
+                std::string const& value = args[++i];
+                if (value.size() != 1 || value[0] < '2' || value[0] > static_cast<char>('0' + frac::s_maxDegree)) {
+                    return fail("expected a degree from 2 to " + std::to_string(frac::s_maxDegree) + " after -d");
+                }
+                job.bezierDegree = static_cast<unsigned int>(value[0] - '0');
+            } else if (option == "-e" && hasValue) {
+                std::string const& value = args[++i];
+                if (value.size() != 1 || value[0] < '1' || value[0] > static_cast<char>('0' + frac::s_maxDegree)) {
+                    return fail("expected a degree from 1 to " + std::to_string(frac::s_maxDegree) + " after -e");
+                }
+                job.cantorDegree = static_cast<unsigned int>(value[0] - '0');
+            } else if (option == "-g" && hasValue) {
+                std::string const& value = args[++i];
+                if (value.empty() || value.size() > 19 || value.find_first_not_of("0123456789") != std::string::npos) {
+                    return fail("expected a nb of points after -g");
+                }
+                job.nbPoints = std::stoull(value);
+            } else if (option == "-l" && hasValue) {
+                job.libraryPath = args[++i];
+            } else if (option == "-p" && hasValue) {
+                if (!frac::FloatFormat::fromStr(args[++i], job.floatFormat)) {
+                    return fail("expected 'shortest' or a nb of digits up to " + std::to_string(frac::FloatFormat::s_maxPrecision) + " after -p");
+                }
+            } else if ((option == "-i" || option == "-j") && hasValue) {
+                std::string const& value = args[++i];
+                // 9 digits always fit an unsigned int
+                if (value.empty() || value.size() > 9 || value.find_first_not_of("0123456789") != std::string::npos) {
+                    return fail("expected a non negative integer below 1000000000 after " + option);
+                }
+                (option == "-i" ? job.nbIterAutoSubs : job.nbThreads) = static_cast<unsigned int>(std::stoul(value));
+            } else {
+                return fail("unknown option " + option);
+            }
+        }
+        jobs.push_back(job);
+    }
+    return true;
+}
+
+std::vector<frac::JobResult> frac::runJobs(std::vector<frac::JobOptions> const& jobs, unsigned int nbThreads) {
+    // the size of the input predicts the time of a job, largest jobs start first so that none ends the batch alone
+    std::vector<std::uintmax_t> sizes(jobs.size(), 0);
+    for (std::size_t i = 0; i < jobs.size(); i++) {
+        std::error_code ec;
+        std::uintmax_t size = std::filesystem::file_size(jobs[i].input, ec);
+        sizes[i] = ec ? 0 : size;
+    }
+    std::vector<std::size_t> order(jobs.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&sizes](std::size_t a, std::size_t b) { return sizes[a] > sizes[b]; });
+
+    frac::LibraryIndex library;
+    std::vector<frac::JobResult> results(jobs.size());
+    std::atomic<std::size_t> next { 0 };
+    frac::WorkStealingPool pool(nbThreads);
+    // each thread takes the next largest job when it is done with one
+    pool.run(pool.nbThreads(), [&](std::size_t) {
+        std::size_t k;
+        while ((k = next++) < order.size()) {
+            std::ostringstream log;
+            results[order[k]] = frac::runJob(jobs[order[k]], library, log);
+        }
+    });
+    return results;
+}
@@ -0,0 +1,185 @@
+#include "fractal/springmasssolver.h"
+#include "fractal/controlpointlayout.h"
+#include "fractal/structure.h"
+#include "fractal/subdivisiongraph.h"
+#include "fractal/subdivisionmatrices.h"
+#include "utils/workstealingpool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace {
+
+std::size_t findRoot(std::vector<std::size_t>& parents, std::size_t i) {
+    while (parents[i] != i) {
+        parents[i] = parents[parents[i]];
+        i = parents[i];
+    }
+    return i;
+}
+
+} // namespace
+
+frac::SpringMassSolver::SpringMassSolver(frac::Structure const& structure) : m_structure(structure) {}
+
+void frac::SpringMassSolver::solve(unsigned int nbThreads) {
+    std::size_t nbCells = m_structure.graph().nbCells();
+    m_matrices = frac::CellMatrices(nbCells);
+    m_nbIterations.assign(nbCells, 0);
+    m_converged.assign(nbCells, 0);
+    // cells do not share points, each one is solved on its own
+    frac::WorkStealingPool pool(nbThreads);
+    pool.run(nbCells, [this](std::size_t i) {
+        bool converged = false;
+        m_matrices.set(i, this->solveCell(i, m_nbIterations[i], converged));
+        m_converged[i] = converged ? 1 : 0;
+    });
+}
+
+frac::CellMatrices const& frac::SpringMassSolver::matrices() const {
+    return m_matrices;
+}
+
+unsigned int frac::SpringMassSolver::nbIterations() const {
+    return m_nbIterations.empty() ? 0 : *std::max_element(m_nbIterations.begin(), m_nbIterations.end());
+}
+
+std::size_t frac::SpringMassSolver::nbUnconverged() const {
+    return static_cast<std::size_t>(std::count(m_converged.begin(), m_converged.end(), 0));
+}
+
+std::string frac::SpringMassSolver::solveCell(std::size_t index, unsigned int& nbIterations, bool& converged) const {
+    frac::SubdivisionGraph const& graph = m_structure.graph();
+    frac::Face const& cell = graph.cell(index);
+    frac::BezierType bezierType = m_structure.bezierType();
+    frac::CantorType cantorType = m_structure.cantorType();
+    frac::ControlPointLayout cellLayout(cell, bezierType, cantorType);
+    std::size_t n = cellLayout.nbControlPoints();
+
+    // control points of all the subdivisions, those of subdivision k start at firsts[k],
+    // the edges of the constraints are counted from the first edge of the cell of the subdivision, as the matrices
+    std::vector<frac::ControlPointLayout> layouts;
+    std::vector<std::size_t> firsts = { 0 };
+    for (std::size_t k = 0; k < graph.nbChildren(index); k++) {
+        layouts.emplace_back(graph.cell(graph.childIndex(index, k)), bezierType, cantorType);
+        firsts.push_back(firsts.back() + layouts.back().nbControlPoints());
+    }
+    std::size_t nbPoints = firsts.back();
+
+    // a point shared by two subdivisions is one point of the system
+    std::vector<std::size_t> parents(nbPoints);
+    std::iota(parents.begin(), parents.end(), 0);
+    for (frac::AdjacencyConstraint const& c: m_structure.context().adjacencyConstraints(cell.id())) {
+        std::vector<std::size_t> first = layouts[c.sub1].controlPointIndices(c.bord1);
+        std::vector<std::size_t> second = layouts[c.sub2].controlPointIndices(c.bord2, true);
+        for (std::size_t j = 0; j < first.size() && j < second.size(); j++) {
+            parents[findRoot(parents, firsts[c.sub1] + first[j])] = findRoot(parents, firsts[c.sub2] + second[j]);
+        }
+    }
+    std::vector<std::size_t> points(nbPoints);
+    std::size_t nbUnique = 0;
+    {
+        std::vector<std::size_t> indexOfRoot(nbPoints, nbPoints);
+        for (std::size_t p = 0; p < nbPoints; p++) {
+            std::size_t root = findRoot(parents, p);
+            if (indexOfRoot[root] == nbPoints) {
+                indexOfRoot[root] = nbUnique++;
+            }
+            points[p] = indexOfRoot[root];
+        }
+    }
+
+    // the weights of point i are the n values from i * n, free points start at the centroid of the cell
+    std::vector<double> weights(nbUnique * n, 1.0 / static_cast<double>(n));
+    std::vector<bool> fixed(nbUnique, false);
+    for (frac::IncidenceConstraint const& c: m_structure.context().incidenceConstraints(cell.id())) {
+        frac::Edge const& edge = cell[c.bord];
+        unsigned int degree = edge.edgeType() == frac::EdgeType::CANTOR ? frac::degree(cantorType) : frac::degree(bezierType);
+        std::vector<double> piece = frac::edgePieceMatrix(edge, degree, c.sub);
+        std::vector<std::size_t> cellPoints = cellLayout.controlPointIndices(c.bord);
+        std::vector<std::size_t> subPoints = layouts[c.subFace].controlPointIndices(c.subFaceBord);
+        for (std::size_t j = 0; j <= degree && j < subPoints.size(); j++) {
+            std::size_t p = points[firsts[c.subFace] + subPoints[j]];
+            double* w = weights.data() + p * n;
+            std::fill(w, w + n, 0.0);
+            for (std::size_t r = 0; r <= degree && r < cellPoints.size(); r++) {
+                w[cellPoints[r]] += piece[r * (degree + 1) + j];
+            }
+            fixed[p] = true;
+        }
+    }
+
+    // springs between consecutive control points of each subdivision, neighbours of point i are in [offsets[i], offsets[i + 1])
+    std::vector<std::pair<std::size_t, std::size_t>> springs;
+    for (std::size_t k = 0; k < layouts.size(); k++) {
+        std::size_t nbCtrlPts = layouts[k].nbControlPoints();
+        for (std::size_t i = 0; i < nbCtrlPts; i++) {
+            std::size_t a = points[firsts[k] + i];
+            std::size_t b = points[firsts[k] + (i + 1) % nbCtrlPts];
+            if (a != b) {
+                springs.emplace_back(a, b);
+                springs.emplace_back(b, a);
+            }
+        }
+    }
+    std::sort(springs.begin(), springs.end());
+    springs.erase(std::unique(springs.begin(), springs.end()), springs.end());
+    std::vector<std::size_t> offsets(nbUnique + 1, 0);
+    std::vector<std::size_t> neighbours;
+    neighbours.reserve(springs.size());
+    for (auto const& [a, b]: springs) {
+        offsets[a + 1]++;
+        neighbours.push_back(b);
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    std::vector<std::size_t> freePoints;
+    for (std::size_t p = 0; p < nbUnique; p++) {
+        if (!fixed[p] && offsets[p + 1] > offsets[p]) {
+            freePoints.push_back(p);
+        }
+    }
+
+    // gauss-seidel sweeps, the weights of a point are contiguous so the loops on them are vectorized
+    std::vector<double> mean(n);
+    nbIterations = 0;
+    // a cell without free points is already still
+    converged = freePoints.empty();
+    while (!converged && nbIterations < s_maxIterations) {
+        nbIterations++;
+        double maxMove = 0.0;
+        for (std::size_t p: freePoints) {
+            std::fill(mean.begin(), mean.end(), 0.0);
+            for (std::size_t e = offsets[p]; e < offsets[p + 1]; e++) {
+                double const* w = weights.data() + neighbours[e] * n;
+                for (std::size_t r = 0; r < n; r++) {
+                    mean[r] += w[r];
+                }
+            }
+            double inverse = 1.0 / static_cast<double>(offsets[p + 1] - offsets[p]);
+            double* w = weights.data() + p * n;
+            for (std::size_t r = 0; r < n; r++) {
+                double value = mean[r] * inverse;
+                maxMove = std::max(maxMove, std::abs(value - w[r]));
+                w[r] = value;
+            }
+        }
+        converged = maxMove < s_tolerance;
+    }
+
+    std::string blob;
+    frac::MatrixBlob::begin(blob, static_cast<std::uint32_t>(layouts.size()));
+    std::vector<double> matrix;
+    for (std::size_t k = 0; k < layouts.size(); k++) {
+        std::size_t nbColumns = layouts[k].nbControlPoints();
+        matrix.assign(n * nbColumns, 0.0);
+        for (std::size_t column = 0; column < nbColumns; column++) {
+            double const* w = weights.data() + points[firsts[k] + column] * n;
+            for (std::size_t row = 0; row < n; row++) {
+                matrix[row * nbColumns + column] = w[row];
+            }
+        }
+        frac::MatrixBlob::appendMatrix(blob, static_cast<std::uint32_t>(n), static_cast<std::uint32_t>(nbColumns), matrix.data());
+    }
+    return blob;
+}
@@ -2,46 +2,32 @@
 #include "utils/utils.h"
 #include <iostream>
 
-frac::Structure::Structure(std::vector<Face> const& faces, BezierType bezierType, CantorType cantorType) : m_faces(faces), m_bezierType(bezierType), m_cantorType(cantorType) {}
+frac::Structure::Structure(SubdivisionContext& context, std::vector<Face> const& faces, BezierType bezierType, CantorType cantorType) : m_context(context), m_faces(faces), m_bezierType(bezierType), m_cantorType(cantorType) {
+    m_layouts.reserve(m_faces.size());
+    for (frac::Face const& f: m_faces) {
+        m_layouts.emplace_back(f, m_bezierType, m_cantorType);
+    }
+}
 
 void frac::Structure::addAdjacency(Adjacency const& adj) {
     if (m_faces[adj.Face1][adj.Edge1] == m_faces[adj.Face2][adj.Edge2]) {
-        std::size_t offset1 = m_faces[adj.Face1].offset();
-        std::size_t offset2 = m_faces[adj.Face2].offset();
-        std::size_t edge1 = static_cast<std::size_t>(frac::utils::mod(static_cast<int>(adj.Edge1) - static_cast<int>(offset1), static_cast<int>(m_faces[adj.Face1].len())));
-        std::size_t edge2 = static_cast<std::size_t>(frac::utils::mod(static_cast<int>(adj.Edge2) - static_cast<int>(offset2), static_cast<int>(m_faces[adj.Face2].len())));
-        m_strAdjacency += "    init(Sub('" + std::to_string(adj.Face1) + "') + Bord('" + std::to_string(edge1) + "') + Permut('0'), Sub('" + std::to_string(adj.Face2) + "') + Bord('" + std::to_string(edge2) + "'))\n";
         m_adjacencies.push_back(adj);
     }
 }
 
-frac::Set<frac::Edge> frac::Structure::allEdges() const {
-    frac::Set<frac::Edge> res;
-    frac::Set<frac::Face> faces = this->allFaces();
-    for (frac::Face const& f: faces.data()) {
-        for (frac::Edge const& e: f.constData()) {
-            res.add(e);
-        }
+frac::SubdivisionGraph const& frac::Structure::graph() const {
+    if (!m_graph) {
+        m_graph = std::make_unique<frac::SubdivisionGraph>(m_context, m_faces);
     }
-    return res;
+    return *m_graph;
 }
 
-frac::Set<frac::Face> frac::Structure::allFaces() const {
-    frac::Set<frac::Face> res;
-    for (frac::Face const& f: this->m_faces) {
-        res.add(f);
-    }
-    for (frac::Face const& f: this->m_faces) {
-        frac::Set<frac::Face> subdivisions = f.allSubdivisions();
-        for (frac::Face const& sub: subdivisions.data()) {
-            res.add(sub);
-        }
-    }
-    return res;
+std::size_t frac::Structure::nbControlPointsOfFace(std::size_t indexFace) const {
+    return m_layouts[indexFace].nbControlPoints();
 }
 
-std::size_t frac::Structure::nbControlPointsOfFace(std::size_t indexFace) const {
-    return m_faces[indexFace].nbControlPoints(m_bezierType, m_cantorType);
+frac::ControlPointLayout const& frac::Structure::layout(std::size_t indexFace) const {
+    return m_layouts[indexFace];
 }
 
 namespace frac {
@@ -49,7 +35,7 @@ std::ostream& operator<<(std::ostream& os, frac::Structure const& structure) {
     for (frac::Face const& f: structure.m_faces) {
         os << f << std::endl;
     }
-    os << structure.m_strAdjacency;
+    os << structure.strAdjacencies();
     return os;
 }
 }
@@ -77,7 +63,15 @@ frac::Face const& frac::Structure::operator[](std::size_t index) const {
 }
 
 std::string frac::Structure::strAdjacencies() const {
-    return this->m_strAdjacency;
+    std::string res;
+    for (Adjacency const& adj: m_adjacencies) {
+        std::size_t offset1 = m_faces[adj.Face1].offset();
+        std::size_t offset2 = m_faces[adj.Face2].offset();
+        std::size_t edge1 = static_cast<std::size_t>(frac::utils::mod(static_cast<int>(adj.Edge1) - static_cast<int>(offset1), static_cast<int>(m_faces[adj.Face1].len())));
+        std::size_t edge2 = static_cast<std::size_t>(frac::utils::mod(static_cast<int>(adj.Edge2) - static_cast<int>(offset2), static_cast<int>(m_faces[adj.Face2].len())));
+        res += "    init(Sub('" + std::to_string(adj.Face1) + "') + Bord('" + std::to_string(edge1) + "') + Permut('0'), Sub('" + std::to_string(adj.Face2) + "') + Bord('" + std::to_string(edge2) + "'))\n";
+    }
+    return res;
 }
 
 const std::vector<frac::Face>& frac::Structure::faces() const {
@@ -89,43 +83,15 @@ std::vector<frac::Adjacency> const& frac::Structure::adjacencies() const {
 }
 
 std::vector<std::size_t> frac::Structure::controlPointIndices(std::size_t indexEdge, std::size_t indexFace, bool reverse) const {
-    std::vector<std::size_t> res = {};
-    std::size_t current = 0;
-    for (std::size_t i = 0; i < indexEdge; i++) {
-        //add to current the number of control points on the edge minus one
-        current += m_faces[indexFace][i].nbControlPoints(m_bezierType, m_cantorType) - 1;
-    }
-    res.emplace_back(current); //first control point index
-
-    std::size_t nbInternCtrlPts = m_faces[indexFace][indexEdge].nbInternControlPoints(m_bezierType, m_cantorType);
-    for (std::size_t i = 1; i <= nbInternCtrlPts; i++) {
-        res.emplace_back((current + i) % this->nbControlPointsOfFace(indexFace)); //intern control points indices
-    }
-
-    res.emplace_back((current + nbInternCtrlPts + 1) % this->nbControlPointsOfFace(indexFace)); //last control point index
-
-    if (reverse) {
-        std::reverse(res.begin(), res.end());
-    }
-
-    return res;
+    return m_layouts[indexFace].controlPointIndices(indexEdge, reverse);
 }
 
 bool frac::Structure::isInternControlPoint(std::size_t indexControlPoint, std::size_t indexFace) const {
-    bool res = indexControlPoint != 0;
-    std::size_t current = 0;
-    for (std::size_t i = 0; i < m_faces[indexFace].constData().size(); i++) {
-        current += m_faces[indexFace][i].nbControlPoints(m_bezierType, m_cantorType) - 1;
-        if (current == indexControlPoint) {
-            res = false;
-        }
-    }
-    return res;
+    return m_layouts[indexFace].isInternControlPoint(indexControlPoint);
 }
 
 bool frac::Structure::isControlPointBelongEdge(std::size_t indexControlPoint, std::size_t indexFace, std::size_t indexEdge) const {
-    std::vector<std::size_t> indices = this->controlPointIndices(indexEdge, indexFace);
-    return std::find(indices.begin(), indices.end(), indexControlPoint) != indices.end();
+    return m_layouts[indexFace].isControlPointBelongEdge(indexControlPoint, indexEdge);
 }
 
 frac::BezierType frac::Structure::bezierType() const {
@@ -135,3 +101,7 @@ frac::BezierType frac::Structure::bezierType() const {
 frac::CantorType frac::Structure::cantorType() const {
     return m_cantorType;
 }
+
+frac::SubdivisionContext& frac::Structure::context() const {
+    return m_context;
+}
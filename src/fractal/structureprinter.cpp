@@ -1,544 +1,310 @@
-#include <filesystem>
-#include <fstream>
+#include <algorithm>
 #include <iostream>
 #include <utility>
 #include "fractal/structureprinter.h"
 
+#include "fractal/edgestateemitter.h"
 #include "fractal/face.h"
 #include "fractal/structure.h"
+#include "fractal/subdivisiongraph.h"
+#include "utils/libraryprefetch.h"
 #include "utils/utils.h"
-#include "utils/point2d.h"
+#include "utils/coordinatestore.h"
 
-frac::StructurePrinter::StructurePrinter(frac::Structure const& structure, bool planarControlPoints, std::string filename, unsigned int nbIterAutoSubs, std::string libPath, std::vector<std::vector<Point2D>> const& coords) :
-        m_structure(structure), m_planarControlPoints(planarControlPoints), m_filename(std::move(filename)), m_coords(coords), m_nbIterAutoSubs(nbIterAutoSubs), m_libPath(std::move(libPath)) {}
+frac::StructurePrinter::StructurePrinter(frac::Structure const& structure, bool planarControlPoints, frac::OutputSink& output, unsigned int nbIterAutoSubs, std::string libPath, frac::CoordinateStore const* coords, frac::LibraryIndex* library) :
+        m_structure(structure), m_planarControlPoints(planarControlPoints), m_coords(coords), m_output(output), m_nbIterAutoSubs(nbIterAutoSubs), m_libPath(std::move(libPath)), m_library(library != nullptr ? library : &m_ownLibrary) {}
+
+void frac::StructurePrinter::setFloatFormat(frac::FloatFormat const& format) {
+    m_floatFormat = format;
+}
+
+void frac::StructurePrinter::setFallbackMatrices(frac::CellMatrices const* matrices) {
+    m_fallbackMatrices = matrices;
+}
+
+void frac::StructurePrinter::setSolvedMatrices(frac::CellMatrices const* matrices) {
+    m_solvedMatrices = matrices;
+}
 
 void frac::StructurePrinter::exportStruct() {
     this->print_header();
     this->print_vertex_state();
-    m_filePrinter.append_nl("    ##############################");
-    m_filePrinter.append_nl("    # all edges states");
-    auto edges = m_structure.allEdges();
-    for (auto const& edge: edges.data()) {
-        this->print_decl_of_edge(edge);
-    }
+    frac::SubdivisionGraph const& graph = m_structure.graph();
 
-    m_filePrinter.append_nl("    ##############################");
-    m_filePrinter.append_nl("    # all edges impl");
-    for (auto const& edge: edges.data()) {
-        this->print_impl_of_edge(edge);
+    // the matrices of the cells are read while the other sections are written
+    std::vector<std::string> keys;
+    keys.reserve(graph.nbCells());
+    for (auto const& c: graph.cells()) {
+        keys.push_back(frac::LibraryPack::keyOf(c.toString()));
     }
+    frac::LibraryPrefetch prefetch(*m_library, m_libPath, std::move(keys));
 
-    m_filePrinter.append_nl("    ##############################");
-    m_filePrinter.append_nl("    # all cells states");
-    auto cells = m_structure.allFaces();
-    for (auto const& c: cells.data()) {
-        m_filePrinter.append_nl("    # " + c.toString());
-        m_filePrinter.append_nl("    " + c.name() + " = Etat('" + c.toString() + "', 0)");
+    this->print_edge_states(graph.edges());
+
+    m_output.append_nl("    ##############################");
+    m_output.append_nl("    # all cells states");
+    auto const& cells = graph.cells();
+    for (auto const& c: cells) {
+        m_output.println("    # ", c.toString());
+        m_output.println("    ", c.name(), " = Etat('", c.toString(), "', 0)");
     }
 
-    m_filePrinter.append_nl("    ##############################");
-    m_filePrinter.append_nl("    # subd of init");
+    m_output.append_nl("    ##############################");
+    m_output.append_nl("    # subd of init");
     this->print_init_subds();
 
-    m_filePrinter.append_nl("    ##############################");
-    m_filePrinter.append_nl("    # edges of all states");
-    for (auto const& c: cells.data()) {
+    m_output.append_nl("    ##############################");
+    m_output.append_nl("    # edges of all states");
+    for (auto const& c: cells) {
         this->print_edges_of_cell(c);
     }
 
-    m_filePrinter.append_nl("    ##############################");
-    m_filePrinter.append_nl("    # subdivisions of all states");
-    for (auto const& c: cells.data()) {
+    m_output.append_nl("    ##############################");
+    m_output.append_nl("    # subdivisions of all states");
+    for (auto const& c: cells) {
         this->print_subd_of_cell(c);
     }
 
-    m_filePrinter.append_nl("    ##############################");
-    m_filePrinter.append_nl("    # build intern of all states");
-    for (auto const& c: cells.data()) {
-        m_filePrinter.append_nl("    " + c.name() + ".buildIntern()");
+    m_output.append_nl("    ##############################");
+    m_output.append_nl("    # build intern of all states");
+    for (auto const& c: cells) {
+        m_output.println("    ", c.name(), ".buildIntern()");
     }
 
-    m_filePrinter.append_nl("    ##############################");
-    m_filePrinter.append_nl("    # spaces of all states");
-    for (auto const& c: cells.data()) {
+    m_output.append_nl("    ##############################");
+    m_output.append_nl("    # spaces of all states");
+    for (auto const& c: cells) {
         this->print_space_of_cell(c);
     }
 
-    m_filePrinter.append_nl("    ##############################");
-    m_filePrinter.append_nl("    # grid of all states");
-    for (auto const& c: cells.data()) {
-        m_filePrinter.append_nl("    " + c.name() + ".addGrid(Bord)");
+    m_output.append_nl("    ##############################");
+    m_output.append_nl("    # grid of all states");
+    for (auto const& c: cells) {
+        m_output.println("    ", c.name(), ".addGrid(Bord)");
     }
 
-    m_filePrinter.append_nl("    ##############################");
-    m_filePrinter.append_nl("    # prim of all states");
-    for (auto const& c: cells.data()) {
+    m_output.append_nl("    ##############################");
+    m_output.append_nl("    # prim of all states");
+    for (auto const& c: cells) {
         this->print_prim_of_cell(c);
     }
 
-    m_filePrinter.append_nl("    ##############################");
-    m_filePrinter.append_nl("    # constraints of all states");
-    for (auto const& c: cells.data()) {
-        m_filePrinter.append_nl("    # incidence constraints");
-        m_filePrinter.append(Face::s_incidenceConstraints[c.name()]);
-        m_filePrinter.append_nl("    # adjacency constraints");
-        if (Face::s_adjacencyConstraints.find(c.name()) != Face::s_adjacencyConstraints.end()) {
-            m_filePrinter.append(Face::s_adjacencyConstraints[c.name()]);
+    m_output.append_nl("    ##############################");
+    m_output.append_nl("    # constraints of all states");
+    for (auto const& c: cells) {
+        m_output.append_nl("    # incidence constraints");
+        for (frac::IncidenceConstraint const& constraint: m_structure.context().incidenceConstraints(c.id())) {
+            constraint.print(m_output, c.name());
         }
-        m_filePrinter.append_nl("    # edges adjacency constraints");
+        m_output.append_nl("    # adjacency constraints");
+        for (frac::AdjacencyConstraint const& constraint: m_structure.context().adjacencyConstraints(c.id())) {
+            constraint.print(m_output, c.name());
+        }
+        m_output.append_nl("    # edges adjacency constraints");
         this->print_edge_adjacencies_of_cell(c);
     }
 
-    m_filePrinter.append_nl("    # constraints on init cells");
-    m_filePrinter.append(m_structure.strAdjacencies());
+    m_output.append_nl("    # constraints on init cells");
+    m_output.append(m_structure.strAdjacencies());
 
-    m_filePrinter.append_nl("    ");
-    m_filePrinter.append_nl("    ##############################");
-    m_filePrinter.append_nl("    # control points");
+    m_output.append_nl("    ");
+    m_output.append_nl("    ##############################");
+    m_output.append_nl("    # control points");
     if (m_planarControlPoints) {
-        if (m_coords.empty()) {
+        if (m_coords == nullptr || m_coords->empty()) {
             this->print_plan_control_points();
         } else {
             this->print_plan_coords_control_points();
         }
     }
 
-    m_filePrinter.append_nl("    ##############################");
-    m_filePrinter.append_nl("    # load matrices");
-    std::vector<std::string> cellsToSave;
-    for (auto const& c: cells) {
-        std::string folderpath = c.toString();
-        folderpath = frac::utils::replaceAll(folderpath, "/", "--");
-        folderpath = m_libPath + frac::utils::replaceAll(folderpath, " ", "");
-        if (std::filesystem::is_directory(folderpath)) {
-            std::size_t nbSubs = c.subdivisions().size();
-            for (std::size_t i = 0; i < nbSubs; i++) {
-                m_filePrinter.append("    " + c.name() + ".initMat[Sub_('" + std::to_string(i) + "')] = FMat(");
-                std::string filepath = folderpath + "/" + std::to_string(i);
-                std::ifstream ifs(filepath);
-                std::string content((std::istreambuf_iterator<char>(ifs)),
-                                    (std::istreambuf_iterator<char>()));
-                ifs.close();
-                m_filePrinter.append(content);
-                m_filePrinter.append_nl(").setTyp('Var')");
-            }
-        } else {
+    m_output.append_nl("    ##############################");
+    m_output.append_nl("    # load matrices");
+    std::vector<std::string_view> cellsToSave;
+    // the subdivision points of these cells are placed by the script
+    std::vector<std::string_view> cellsToPlace;
+    std::vector<std::optional<frac::MatrixBlob>> const& allMatrices = prefetch.results();
+    for (std::size_t index = 0; index < cells.size(); index++) {
+        frac::Face const& c = cells[index];
+        std::optional<frac::MatrixBlob> matrices = m_solvedMatrices != nullptr ? m_solvedMatrices->matrices(index) : allMatrices[index];
+        if (!matrices.has_value()) {
             cellsToSave.push_back(c.name());
+            if (m_fallbackMatrices != nullptr) {
+                matrices = m_fallbackMatrices->matrices(index);
+            }
+            if (!matrices.has_value()) {
+                cellsToPlace.push_back(c.name());
+                continue;
+            }
+        }
+        // the scripts save one matrix less than the nb of subdivisions
+        std::size_t nbMatrices = std::min(matrices->size(), graph.nbChildren(index));
+        for (std::size_t i = 0; i < nbMatrices; i++) {
+            m_output.print("    ", c.name(), ".initMat[Sub_('", i, "')] = FMat(");
+            this->print_matrix(matrices.value(), i);
+            m_output.append_nl(").setTyp('Var')");
         }
     }
 
-    m_filePrinter.append_nl("    ");
-    m_filePrinter.append_nl("    ##############################");
-    m_filePrinter.append_nl("    # auto subdivision points and save matrices");
-    m_filePrinter.append("    allCellsToSave = [");
+    m_output.append_nl("    ");
+    m_output.append_nl("    ##############################");
+    m_output.append_nl("    # auto subdivision points and save matrices");
+    m_output.append("    allCellsToSave = [");
     bool first = true;
     for (auto const& c: cellsToSave) {
-        m_filePrinter.append((first ? "" : ", ") + c);
+        m_output.print(first ? "" : ", ", c);
         first = false;
     }
-    m_filePrinter.append_nl("]");
+    m_output.append_nl("]");
 
-    m_filePrinter.append_nl("    auto = Auto(init)");
-    m_filePrinter.append_nl("    auto.initDic()");
-    m_filePrinter.append_nl("    for etat in auto.figMax:");
-    m_filePrinter.append("        auto.autoSubBar(etat, " + std::to_string(m_nbIterAutoSubs) + ", [''");
-    for (auto const& c: cellsToSave) {
-        m_filePrinter.append(", " + c + ".name");
+    m_output.append_nl("    auto = Auto(init)");
+    m_output.append_nl("    auto.initDic()");
+    m_output.append_nl("    for etat in auto.figMax:");
+    m_output.print("        auto.autoSubBar(etat, ", m_nbIterAutoSubs, ", [''");
+    for (auto const& c: cellsToPlace) {
+        m_output.print(", ", c, ".name");
     }
-    m_filePrinter.append_nl("])");
+    m_output.append_nl("])");
 
     this->print_footer();
-    m_filePrinter.printToFile(m_filename);
+    m_output.flush();
 }
 
 void frac::StructurePrinter::print_header() {
-    m_filePrinter.append_nl("from __future__ import division");
-    m_filePrinter.append_nl("import sys");
-    m_filePrinter.append_nl("import os");
-    m_filePrinter.append_nl("");
-    m_filePrinter.append_nl("directory = os.path.realpath(__file__)");
-    m_filePrinter.append_nl("directory = directory[:directory.find('InterfaceBCIFS')] + 'python'");
-    m_filePrinter.append_nl("if directory not in sys.path:");
-    m_filePrinter.append_nl("    sys.path.append(directory)");
-    m_filePrinter.append_nl("from etat import *");
-    m_filePrinter.append_nl("");
-    m_filePrinter.append_nl("");
-    m_filePrinter.append_nl("def modele():");
-    m_filePrinter.append_nl("    init = EtatInit()");
+    m_output.append_nl("from __future__ import division");
+    m_output.append_nl("import sys");
+    m_output.append_nl("import os");
+    m_output.append_nl("import struct");
+    m_output.append_nl("");
+    m_output.append_nl("directory = os.path.realpath(__file__)");
+    m_output.append_nl("directory = directory[:directory.find('InterfaceBCIFS')] + 'python'");
+    m_output.append_nl("if directory not in sys.path:");
+    m_output.append_nl("    sys.path.append(directory)");
+    m_output.append_nl("from etat import *");
+    m_output.append_nl("");
+    m_output.append_nl("");
+    m_output.append_nl("def modele():");
+    m_output.append_nl("    init = EtatInit()");
 }
 
 void frac::StructurePrinter::print_vertex_state() {
-    m_filePrinter.append_nl("    s = Etat('s', 1)");
-    m_filePrinter.append_nl("    s.subs = {Sub('0'): s}");
-    m_filePrinter.append_nl("    s.buildIntern()");
-}
-
-void frac::StructurePrinter::print_decl_of_edge(const frac::Edge& edge) {
-    if (edge.edgeType() == EdgeType::CANTOR) {
-        if (edge.isDelay()) {
-            this->print_delay_cantor_decl(edge.nbSubdivisions(), edge.delay());
-        } else {
-            this->print_cantor_n_state_decl(edge.nbSubdivisions());
-        }
-    } else {
-        if (edge.isDelay()) {
-            this->print_delay_bezier_decl(edge.nbSubdivisions(), edge.delay());
-        } else {
-            this->print_bezier_state_decl(edge.nbSubdivisions());
-        }
-    }
-}
-
-void frac::StructurePrinter::print_delay_cantor_decl(unsigned int n, unsigned int delay_count) {
-    m_filePrinter.append_nl("    C" + std::to_string(n) + "_" + std::to_string(delay_count) + " = Etat('C" + std::to_string(n) + "_" + std::to_string(delay_count) + "', " + (m_structure.cantorType() == CantorType::Cubic_Cantor ? "2" : (m_structure.cantorType() == CantorType::Quadratic_Cantor ? "1" : "0")) + ")");
-    m_filePrinter.append_nl("    C" + std::to_string(n) + "_" + std::to_string(delay_count) + ".bords = {Bord('0'): s, Bord('1'): s}");
-    m_filePrinter.append_nl("    C" + std::to_string(n) + "_" + std::to_string(delay_count) + ".permuts = {Permut('0'): C" + std::to_string(n) + "_" + std::to_string(delay_count) + "}");
+    m_output.append_nl("    s = Etat('s', 1)");
+    m_output.append_nl("    s.subs = {Sub('0'): s}");
+    m_output.append_nl("    s.buildIntern()");
 }
 
-void frac::StructurePrinter::print_cantor_n_state_decl(unsigned int n) {
-    m_filePrinter.append_nl("    C" + std::to_string(n) + " = Etat('C" + std::to_string(n) + "', " + (m_structure.cantorType() == CantorType::Cubic_Cantor ? "2" : (m_structure.cantorType() == CantorType::Quadratic_Cantor ? "1" : "0")) + ")");
-    m_filePrinter.append_nl("    C" + std::to_string(n) + ".bords = {Bord('0'): s, Bord('1'): s}");
-    m_filePrinter.append_nl("    C" + std::to_string(n) + ".permuts = {Permut('0'): C" + std::to_string(n) + "}");
-}
-
-void frac::StructurePrinter::print_delay_bezier_decl(unsigned int n, unsigned int delay_count) {
-    m_filePrinter.append_nl("    B" + std::to_string(n) + "_" + std::to_string(delay_count) + " = Etat('B" + std::to_string(n) + "_" + std::to_string(delay_count) + "', " + (m_structure.bezierType() == BezierType::Cubic_Bezier ? "2" : "1") + ")");
-    m_filePrinter.append_nl("    B" + std::to_string(n) + "_" + std::to_string(delay_count) + ".bords = {Bord('0'): s, Bord('1'): s}");
-    m_filePrinter.append_nl("    B" + std::to_string(n) + "_" + std::to_string(delay_count) + ".permuts = {Permut('0'): B" + std::to_string(n) + "_" + std::to_string(delay_count) + "}");
-}
+void frac::StructurePrinter::print_edge_states(frac::Set<frac::Edge> const& edges) {
+    // the emitters of the bezier and cantor degrees are chosen once for all the edges
+    frac::EdgeStateEmitters bezier = frac::bezierEmitters(m_structure.bezierType());
+    frac::EdgeStateEmitters cantor = frac::cantorEmitters(m_structure.cantorType());
 
-void frac::StructurePrinter::print_bezier_state_decl(unsigned int n) {
-    m_filePrinter.append_nl("    B" + std::to_string(n) + " = Etat('B" + std::to_string(n) + "', " + (m_structure.bezierType() == BezierType::Cubic_Bezier ? "2" : "1") + ")");
-    m_filePrinter.append_nl("    B" + std::to_string(n) + ".bords = {Bord('0'): s, Bord('1'): s}");
-    m_filePrinter.append_nl("    B" + std::to_string(n) + ".permuts = {Permut('0'): B" + std::to_string(n) + "}");
-}
+    m_output.append_nl("    ##############################");
+    m_output.append_nl("    # all edges states");
+    for (auto const& edge: edges.data()) {
+        frac::EdgeStateEmitters const& emitters = edge.edgeType() == EdgeType::CANTOR ? cantor : bezier;
+        emitters.printDecl(m_output, edge.nbSubdivisions(), edge.delay());
+    }
 
-void frac::StructurePrinter::print_impl_of_edge(const frac::Edge& edge) {
-    if (edge.edgeType() == EdgeType::CANTOR) {
-        if (edge.isDelay()) {
-            this->print_delay_cantor_impl(edge.nbSubdivisions(), edge.delay());
-        } else {
-            this->print_cantor_n_state_impl(edge.nbSubdivisions());
-        }
-    } else {
+    m_output.append_nl("    ##############################");
+    m_output.append_nl("    # all edges impl");
+    for (auto const& edge: edges.data()) {
+        frac::EdgeStateEmitters const& emitters = edge.edgeType() == EdgeType::CANTOR ? cantor : bezier;
         if (edge.isDelay()) {
-            this->print_delay_bezier_impl(edge.nbSubdivisions(), edge.delay());
+            emitters.printDelayImpl(m_output, edge.nbSubdivisions(), edge.delay());
         } else {
-            this->print_bezier_state_impl(edge.nbSubdivisions());
+            emitters.printStateImpl(m_output, edge.nbSubdivisions(), m_floatFormat);
         }
     }
 }
 
-void frac::StructurePrinter::print_delay_cantor_impl(unsigned int n, unsigned int delay_count) {
-    m_filePrinter.append_nl("    C" + std::to_string(n) + "_" + std::to_string(delay_count) + ".subs = {Sub('0'): " + (delay_count > 1 ? "C" + std::to_string(n) + "_" + std::to_string(delay_count - 1) : "C" + std::to_string(n)) + "}");
-    m_filePrinter.append_nl("    C" + std::to_string(n) + "_" + std::to_string(delay_count) + ".buildIntern()");
-    if (m_structure.cantorType() == frac::CantorType::Classic_Cantor) {
-        m_filePrinter.append_nl("    C" + std::to_string(n) + "_" + std::to_string(delay_count) + ".space = [Bord_('0'), Bord_('1')]");
-    } else if (m_structure.cantorType() == frac::CantorType::Quadratic_Cantor) {
-        m_filePrinter.append_nl("    C" + std::to_string(n) + "_" + std::to_string(delay_count) + ".space = [Bord_('0'), Intern_(''), Bord_('1')]");
-    } else {//cubic
-        m_filePrinter.append_nl("    C" + std::to_string(n) + "_" + std::to_string(delay_count) + ".space = [Bord_('0'), Intern_('0'), Intern_('1'), Bord_('1')]");
-    }
-    m_filePrinter.append_nl("    C" + std::to_string(n) + "_" + std::to_string(delay_count) + "(Permut('0') + Bord('0'), Bord('1'))");
-    m_filePrinter.append_nl("    C" + std::to_string(n) + "_" + std::to_string(delay_count) + "(Permut('0') + Bord('1'), Bord('0'))");
-
-    //permut intern
-    if (m_structure.cantorType() == frac::CantorType::Quadratic_Cantor) {
-        m_filePrinter.append_nl("    C" + std::to_string(n) + "_" + std::to_string(delay_count) + "(Permut('0') + Intern(''), Intern(''))");
-    } else if (m_structure.cantorType() == frac::CantorType::Cubic_Cantor) {
-        m_filePrinter.append_nl("    C" + std::to_string(n) + "_" + std::to_string(delay_count) + "(Permut('0') + Intern('0'), Intern('1'))");
-        m_filePrinter.append_nl("    C" + std::to_string(n) + "_" + std::to_string(delay_count) + "(Permut('0') + Intern('1'), Intern('0'))");
-    }
-
-    m_filePrinter.append_nl("    C" + std::to_string(n) + "_" + std::to_string(delay_count) + "(Permut('0') + Sub('0'), Sub('0') + Permut('0'))");
-    m_filePrinter.append_nl("    C" + std::to_string(n) + "_" + std::to_string(delay_count) + "(Bord('0') + Sub('0'), Sub('0') + Bord('0'))");
-    m_filePrinter.append_nl("    C" + std::to_string(n) + "_" + std::to_string(delay_count) + "(Bord('1') + Sub('0'), Sub('0') + Bord('1'))");
-
-    if (m_structure.cantorType() == frac::CantorType::Classic_Cantor) {
-        m_filePrinter.append_nl("    C" + std::to_string(n) + "_" + std::to_string(delay_count) + ".grid.elems = [Figure(1, [Bord_('0'), Bord_('1')])]");
-    } else if (m_structure.cantorType() == frac::CantorType::Quadratic_Cantor) {
-        m_filePrinter.append_nl("    C" + std::to_string(n) + "_" + std::to_string(delay_count) + ".grid.elems = [Figure(1, [Bord_('0'), Intern_(''), Bord_('1')])]");
-    } else {//cubic
-        m_filePrinter.append_nl("    C" + std::to_string(n) + "_" + std::to_string(delay_count) + ".grid.elems = [Figure(1, [Bord_('0'), Intern_('0'), Intern_('1'), Bord_('1')])]");
-    }
-
-    m_filePrinter.append_nl("    C" + std::to_string(n) + "_" + std::to_string(delay_count) + ".prim.elems = [Figure(1, [Bord_('0'), Bord_('1')])]");
-
-    //matrices for intern points
-    if (m_structure.cantorType() == CantorType::Cubic_Cantor) {
-        m_filePrinter.append_nl("    C" + std::to_string(n) + "_" + std::to_string(delay_count) + ".initMat[Sub_('0') + Intern('0')] = FMat([");
-        m_filePrinter.append_nl("        [0.0],");
-        m_filePrinter.append_nl("        [1.0],");
-        m_filePrinter.append_nl("        [0.0],");
-        m_filePrinter.append_nl("        [0.0]]).setTyp('Const')");
-
-        m_filePrinter.append_nl("    C" + std::to_string(n) + "_" + std::to_string(delay_count) + ".initMat[Sub_('0') + Intern('1')] = FMat([");
-        m_filePrinter.append_nl("        [0.0],");
-        m_filePrinter.append_nl("        [0.0],");
-        m_filePrinter.append_nl("        [1.0],");
-        m_filePrinter.append_nl("        [0.0]]).setTyp('Const')");
-    } else if (m_structure.cantorType() == CantorType::Quadratic_Cantor) {
-        m_filePrinter.append_nl("    C" + std::to_string(n) + "_" + std::to_string(delay_count) + ".initMat[Sub_('0') + Intern('')] = FMat([");
-        m_filePrinter.append_nl("        [0.0],");
-        m_filePrinter.append_nl("        [1.0],");
-        m_filePrinter.append_nl("        [0.0]]).setTyp('Const')");
-    }
-}
-
-void frac::StructurePrinter::print_cantor_n_state_impl(unsigned int n) {
-    m_filePrinter.append("    C" + std::to_string(n) + ".subs = {");
-    for (unsigned int i = 0; i < n - 1; ++i) {
-        m_filePrinter.append("Sub('" + std::to_string(i) + "'): C" + std::to_string(n) + ", ");
-    }
-    m_filePrinter.append_nl("Sub('" + std::to_string(n - 1) + "'): C" + std::to_string(n) + "}");
-    m_filePrinter.append_nl("    C" + std::to_string(n) + ".buildIntern()");
-
-    if (m_structure.cantorType() == frac::CantorType::Classic_Cantor) {
-        m_filePrinter.append_nl("    C" + std::to_string(n) + ".space = [Bord_('0'), Bord_('1')]");
-    } else if (m_structure.cantorType() == frac::CantorType::Quadratic_Cantor) {
-        m_filePrinter.append_nl("    C" + std::to_string(n) + ".space = [Bord_('0'), Intern_(''), Bord_('1')]");
-    } else {//cubic
-        m_filePrinter.append_nl("    C" + std::to_string(n) + ".space = [Bord_('0'), Intern_('0'), Intern_('1'), Bord_('1')]");
-    }
-
-    m_filePrinter.append_nl("    C" + std::to_string(n) + "(Permut('0') + Bord('0'), Bord('1'))");
-    m_filePrinter.append_nl("    C" + std::to_string(n) + "(Permut('0') + Bord('1'), Bord('0'))");
-    for (unsigned int i = 0; i < n; ++i) {
-        m_filePrinter.append_nl("    C" + std::to_string(n) + "(Permut('0') + Sub('" + std::to_string(i) + "'), Sub('" + std::to_string(n - i - 1) + "') + Permut('0'))");
-    }
-
-    //permut intern
-    if (m_structure.cantorType() == frac::CantorType::Quadratic_Cantor) {
-        m_filePrinter.append_nl("    C" + std::to_string(n) + "(Permut('0') + Intern(''), Intern(''))");
-    } else if (m_structure.cantorType() == frac::CantorType::Cubic_Cantor) {
-        m_filePrinter.append_nl("    C" + std::to_string(n) + "(Permut('0') + Intern('0'), Intern('1'))");
-        m_filePrinter.append_nl("    C" + std::to_string(n) + "(Permut('0') + Intern('1'), Intern('0'))");
-    }
-
-    m_filePrinter.append_nl("    C" + std::to_string(n) + "(Bord('0') + Sub('0'), Sub('0') + Bord('0'))");
-    m_filePrinter.append_nl("    C" + std::to_string(n) + "(Bord('1') + Sub('0'), Sub(" + std::to_string(n - 1) + ") + Bord('1'))");
-
-    if (m_structure.cantorType() == frac::CantorType::Classic_Cantor) {
-        m_filePrinter.append_nl("    C" + std::to_string(n) + ".grid.elems = [Figure(1, [Bord_('0'), Bord_('1')])]");
-    } else if (m_structure.cantorType() == frac::CantorType::Quadratic_Cantor) {
-        m_filePrinter.append_nl("    C" + std::to_string(n) + ".grid.elems = [Figure(1, [Bord_('0'), Intern_(''), Bord_('1')])]");
-    } else {//cubic
-        m_filePrinter.append_nl("    C" + std::to_string(n) + ".grid.elems = [Figure(1, [Bord_('0'), Intern_('0'), Intern_('1'), Bord_('1')])]");
-    }
-
-    //matrices
-    if (m_structure.cantorType() == frac::CantorType::Classic_Cantor) {
-        unsigned int m = n * 2 - 1;
-        unsigned int prem = m - 1;
-        unsigned int deux = 1;
-        m_filePrinter.append_nl("    C" + std::to_string(n) + ".initMat[Sub_('0') + Bord('1')] = FMat([");
-        m_filePrinter.append_nl("        [" + utils::to_string(float(prem) / float(m)) + "],");
-        m_filePrinter.append_nl("        [" + utils::to_string(float(deux) / float(m)) + "]]).setTyp('Const')");
-        prem = prem - 1;
-        deux = deux + 1;
-        for (unsigned int j = 0; j < n - 2; ++j) {
-            m_filePrinter.append_nl("    C" + std::to_string(n) + ".initMat[Sub_('" + std::to_string(j + 1) + "')] = FMat([");
-            m_filePrinter.append_nl("        [" + utils::to_string(float(prem) / float(m)) + ", " + utils::to_string(float(prem - 1) / float(m)) + "],");
-            m_filePrinter.append_nl("        [" + utils::to_string(float(deux) / float(m)) + ", " + utils::to_string(float(deux + 1) / float(m)) + "]]).setTyp('Const')");
-            prem = prem - 2;
-            deux = deux + 2;
-        }
-        m_filePrinter.append_nl("    C" + std::to_string(n) + ".initMat[Sub_('" + std::to_string(n - 1) + "') + Bord('0')] = FMat([");
-        m_filePrinter.append_nl("        [" + utils::to_string(float(prem) / float(m)) + "],");
-        m_filePrinter.append_nl("        [" + utils::to_string(float(deux) / float(m)) + "]]).setTyp('Const')");
-    } else if (m_structure.cantorType() == frac::CantorType::Quadratic_Cantor) {
-        for (unsigned int i = 0; i < n; ++i) {  // for each subdivision T0, T1, ... Tn-1
-            m_filePrinter.append_nl("    C" + std::to_string(n) + ".initMat[Sub_('" + std::to_string(i) + "')] = FMat([");
-            std::vector<float> t = frac::utils::get_bezier_transformation(2 * i, n + n - 1);
-            m_filePrinter.append_nl("        [" + frac::utils::to_string(t[0]) + ", " + frac::utils::to_string(t[1]) + ", " + frac::utils::to_string(t[2]) + "],");
-            m_filePrinter.append_nl("        [" + frac::utils::to_string(t[3]) + ", " + frac::utils::to_string(t[4]) + ", " + frac::utils::to_string(t[5]) + "],");
-            m_filePrinter.append_nl("        [" + frac::utils::to_string(t[6]) + ", " + frac::utils::to_string(t[7]) + ", " + frac::utils::to_string(t[8]) + "]]).setTyp('Const')");
-        }
-    } else {//cubic
-        for (unsigned int i = 0; i < n; ++i) {  // for each subdivision T0, T1, ... Tn-1
-            m_filePrinter.append_nl("    C" + std::to_string(n) + ".initMat[Sub_('" + std::to_string(i) + "')] = FMat([");
-            std::vector<float> t = frac::utils::get_bezier_cubic_transformation(2 * i, n + n - 1);
-            m_filePrinter.append_nl("        [" + frac::utils::to_string(t[0]) + ", " + frac::utils::to_string(t[1]) + ", " + frac::utils::to_string(t[2]) + ", " + frac::utils::to_string(t[3]) + "],");
-            m_filePrinter.append_nl("        [" + frac::utils::to_string(t[4]) + ", " + frac::utils::to_string(t[5]) + ", " + frac::utils::to_string(t[6]) + ", " + frac::utils::to_string(t[7]) + "],");
-            m_filePrinter.append_nl("        [" + frac::utils::to_string(t[8]) + ", " + frac::utils::to_string(t[9]) + ", " + frac::utils::to_string(t[10]) + ", " + frac::utils::to_string(t[11]) + "],");
-            m_filePrinter.append_nl("        [" + frac::utils::to_string(t[12]) + ", " + frac::utils::to_string(t[13]) + ", " + frac::utils::to_string(t[14]) + ", " + frac::utils::to_string(t[15]) + "]]).setTyp('Const')");
-        }
-    }
-}
-
-void frac::StructurePrinter::print_delay_bezier_impl(unsigned int n, unsigned int delay_count) {
-    m_filePrinter.append_nl("    B" + std::to_string(n) + "_" + std::to_string(delay_count) + ".subs = {Sub('0'): " + (delay_count > 1 ? "B" + std::to_string(n) + "_" + std::to_string(delay_count - 1) : "B" + std::to_string(n)) + "}");
-    m_filePrinter.append_nl("    B" + std::to_string(n) + "_" + std::to_string(delay_count) + ".buildIntern()");
-    if (m_structure.bezierType() == BezierType::Cubic_Bezier) {
-        m_filePrinter.append_nl("    B" + std::to_string(n) + "_" + std::to_string(delay_count) + ".space = [Bord_('0'), Intern_('0'), Intern_('1'), Bord_('1')]");
-    } else {
-        m_filePrinter.append_nl("    B" + std::to_string(n) + "_" + std::to_string(delay_count) + ".space = [Bord_('0'), Intern_(''), Bord_('1')]");
-    }
-    m_filePrinter.append_nl("    B" + std::to_string(n) + "_" + std::to_string(delay_count) + "(Permut('0') + Bord('0'), Bord('1'))");
-    m_filePrinter.append_nl("    B" + std::to_string(n) + "_" + std::to_string(delay_count) + "(Permut('0') + Bord('1'), Bord('0'))");
-    if (m_structure.bezierType() == BezierType::Cubic_Bezier) {
-        m_filePrinter.append_nl("    B" + std::to_string(n) + "_" + std::to_string(delay_count) + "(Permut('0') + Intern('0'), Intern('1'))");
-        m_filePrinter.append_nl("    B" + std::to_string(n) + "_" + std::to_string(delay_count) + "(Permut('0') + Intern('1'), Intern('0'))");
-    } else {
-        m_filePrinter.append_nl("    B" + std::to_string(n) + "_" + std::to_string(delay_count) + "(Permut('0') + Intern(''), Intern(''))");
-    }
-    m_filePrinter.append_nl("    B" + std::to_string(n) + "_" + std::to_string(delay_count) + "(Permut('0') + Sub('0'), Sub('0') + Permut('0'))");
-    m_filePrinter.append_nl("    B" + std::to_string(n) + "_" + std::to_string(delay_count) + "(Bord('0') + Sub('0'), Sub('0') + Bord('0'))");
-    m_filePrinter.append_nl("    B" + std::to_string(n) + "_" + std::to_string(delay_count) + "(Bord('1') + Sub('0'), Sub('0') + Bord('1'))");
-    if (m_structure.bezierType() == BezierType::Cubic_Bezier) {
-        m_filePrinter.append_nl("    B" + std::to_string(n) + "_" + std::to_string(delay_count) + ".grid.elems = [Figure(1, [Bord_('0'), Intern_('0'), Intern_('1'), Bord_('1')])]");
-    } else {
-        m_filePrinter.append_nl("    B" + std::to_string(n) + "_" + std::to_string(delay_count) + ".grid.elems = [Figure(1, [Bord_('0'), Intern_(''), Bord_('1')])]");
-    }
-    m_filePrinter.append_nl("    B" + std::to_string(n) + "_" + std::to_string(delay_count) + ".prim.elems = [Figure(1, [Bord_('0'), Bord_('1')])]");
-    if (m_structure.bezierType() == BezierType::Cubic_Bezier) {
-        m_filePrinter.append_nl("    B" + std::to_string(n) + "_" + std::to_string(delay_count) + ".initMat[Sub_('0') + Intern('0')] = FMat([");
-        m_filePrinter.append_nl("        [0.0],");
-        m_filePrinter.append_nl("        [1.0],");
-        m_filePrinter.append_nl("        [0.0],");
-        m_filePrinter.append_nl("        [0.0]]).setTyp('Const')");
-
-        m_filePrinter.append_nl("    B" + std::to_string(n) + "_" + std::to_string(delay_count) + ".initMat[Sub_('0') + Intern('1')] = FMat([");
-        m_filePrinter.append_nl("        [0.0],");
-        m_filePrinter.append_nl("        [0.0],");
-        m_filePrinter.append_nl("        [1.0],");
-        m_filePrinter.append_nl("        [0.0]]).setTyp('Const')");
-    } else {
-        m_filePrinter.append_nl("    B" + std::to_string(n) + "_" + std::to_string(delay_count) + ".initMat[Sub_('0') + Intern('')] = FMat([");
-        m_filePrinter.append_nl("        [0.0],");
-        m_filePrinter.append_nl("        [1.0],");
-        m_filePrinter.append_nl("        [0.0]]).setTyp('Const')");
-    }
-}
-
-void frac::StructurePrinter::print_bezier_state_impl(unsigned int n) {
-    m_filePrinter.append("    B" + std::to_string(n) + ".subs = {");
-    for (unsigned int i = 0; i < n - 1; ++i) {
-        m_filePrinter.append("Sub('" + std::to_string(i) + "'): B" + std::to_string(n) + ", ");
-    }
-    m_filePrinter.append_nl("Sub('" + std::to_string(n - 1) + "'): B" + std::to_string(n) + "}");
-    m_filePrinter.append_nl("    B" + std::to_string(n) + ".buildIntern()");
-    if (m_structure.bezierType() == BezierType::Cubic_Bezier) {
-        m_filePrinter.append_nl("    B" + std::to_string(n) + ".space = [Bord_('0'), Intern_('0'), Intern_('1'), Bord_('1')]");
-    } else {
-        m_filePrinter.append_nl("    B" + std::to_string(n) + ".space = [Bord_('0'), Intern_(''), Bord_('1')]");
-    }
-    m_filePrinter.append_nl("    B" + std::to_string(n) + "(Permut('0') + Bord('0'), Bord('1'))");
-    m_filePrinter.append_nl("    B" + std::to_string(n) + "(Permut('0') + Bord('1'), Bord('0'))");
-    if (m_structure.bezierType() == BezierType::Cubic_Bezier) {
-        m_filePrinter.append_nl("    B" + std::to_string(n) + "(Permut('0') + Intern('0'), Intern('1'))");
-        m_filePrinter.append_nl("    B" + std::to_string(n) + "(Permut('0') + Intern('1'), Intern('0'))");
-    } else {
-        m_filePrinter.append_nl("    B" + std::to_string(n) + "(Permut('0') + Intern(''), Intern(''))");
-    }
-    for (unsigned int i = 0; i < n; ++i) {
-        m_filePrinter.append_nl("    B" + std::to_string(n) + "(Permut('0') + Sub(" + std::to_string(i) + "), Sub(" + std::to_string(n - i - 1) + ") + Permut('0'))");
-    }
-    if (m_structure.bezierType() == BezierType::Cubic_Bezier) {
-        m_filePrinter.append_nl("    B" + std::to_string(n) + ".grid.elems = [Figure(1, [Bord_('0'), Intern_('0'), Intern_('1'), Bord_('1')])]");
-    } else {
-        m_filePrinter.append_nl("    B" + std::to_string(n) + ".grid.elems = [Figure(1, [Bord_('0'), Intern_(''), Bord_('1')])]");
-    }
-    m_filePrinter.append_nl("    B" + std::to_string(n) + ".prim.elems = [Figure(1, [Bord_('0'), Bord_('1')])]");
-    if (m_structure.bezierType() == BezierType::Cubic_Bezier) {
-        for (unsigned int i = 0; i < n; ++i) {  // for each subdivision T0, T1, ... Tn-1
-            m_filePrinter.append_nl("    B" + std::to_string(n) + ".initMat[Sub_('" + std::to_string(i) + "')] = FMat([");
-            std::vector<float> t = frac::utils::get_bezier_cubic_transformation(i, n);
-            m_filePrinter.append_nl("        [" + frac::utils::to_string(t[0]) + ", " + frac::utils::to_string(t[1]) + ", " + frac::utils::to_string(t[2]) + ", " + frac::utils::to_string(t[3]) + "],");
-            m_filePrinter.append_nl("        [" + frac::utils::to_string(t[4]) + ", " + frac::utils::to_string(t[5]) + ", " + frac::utils::to_string(t[6]) + ", " + frac::utils::to_string(t[7]) + "],");
-            m_filePrinter.append_nl("        [" + frac::utils::to_string(t[8]) + ", " + frac::utils::to_string(t[9]) + ", " + frac::utils::to_string(t[10]) + ", " + frac::utils::to_string(t[11]) + "],");
-            m_filePrinter.append_nl("        [" + frac::utils::to_string(t[12]) + ", " + frac::utils::to_string(t[13]) + ", " + frac::utils::to_string(t[14]) + ", " + frac::utils::to_string(t[15]) + "]]).setTyp('Const')");
-        }
-    } else {
-        for (unsigned int i = 0; i < n; ++i) {  // for each subdivision T0, T1, ... Tn-1
-            m_filePrinter.append_nl("    B" + std::to_string(n) + ".initMat[Sub_('" + std::to_string(i) + "')] = FMat([");
-            std::vector<float> t = frac::utils::get_bezier_transformation(i, n);
-            m_filePrinter.append_nl("        [" + frac::utils::to_string(t[0]) + ", " + frac::utils::to_string(t[1]) + ", " + frac::utils::to_string(t[2]) + "],");
-            m_filePrinter.append_nl("        [" + frac::utils::to_string(t[3]) + ", " + frac::utils::to_string(t[4]) + ", " + frac::utils::to_string(t[5]) + "],");
-            m_filePrinter.append_nl("        [" + frac::utils::to_string(t[6]) + ", " + frac::utils::to_string(t[7]) + ", " + frac::utils::to_string(t[8]) + "]]).setTyp('Const')");
-        }
+void frac::StructurePrinter::print_edge_name(frac::Edge const& edge) {
+    m_output.print(edge.edgeType() == EdgeType::BEZIER ? 'B' : 'C', edge.nbSubdivisions());
+    if (edge.isDelay()) {
+        m_output.print('_', edge.delay());
     }
 }
 
 void frac::StructurePrinter::print_init_subds() {
     auto const& subds = m_structure.faces();
-    m_filePrinter.append("    init.subs = {");
+    m_output.append("    init.subs = {");
     int i = 0;
     for (auto const& s: subds) {
         if (i == 0) {
-            m_filePrinter.append("Sub('" + std::to_string(i) + "'): " + s.name());
+            m_output.print("Sub('", i, "'): ", s.name());
         } else {
-            m_filePrinter.append(", Sub('" + std::to_string(i) + "'): " + s.name());
+            m_output.print(", Sub('", i, "'): ", s.name());
         }
         i += 1;
     }
-    m_filePrinter.append_nl("}");
+    m_output.append_nl("}");
 }
 
 void frac::StructurePrinter::print_edges_of_cell(frac::Face const& cell) {
-    m_filePrinter.append("    " + cell.name() + ".bords = {");
+    m_output.print("    ", cell.name(), ".bords = {");
     int i = 0;
     for (auto const& edge: cell.constData()) {
         if (i == 0) {
-            m_filePrinter.append("Bord('" + std::to_string(i) + "'): " + edge.name());
+            m_output.print("Bord('", i, "'): ");
         } else {
-            m_filePrinter.append(", Bord('" + std::to_string(i) + "'): " + edge.name());
+            m_output.print(", Bord('", i, "'): ");
         }
+        this->print_edge_name(edge);
         i += 1;
     }
-    m_filePrinter.append_nl("}");
+    m_output.append_nl("}");
 }
 
 void frac::StructurePrinter::print_subd_of_cell(frac::Face const& cell) {
-    std::vector<frac::Face> subds = cell.subdivisions();
-    m_filePrinter.append("    " + cell.name() + ".subs = {");
+    frac::SubdivisionGraph const& graph = m_structure.graph();
+    std::size_t index = graph.indexOf(cell);
+    m_output.print("    ", cell.name(), ".subs = {");
     int i = 0;
-    for (frac::Face const& f: subds) {
+    for (frac::Face const* f = graph.childrenBegin(index); f != graph.childrenEnd(index); ++f) {
         if (i == 0) {
-            m_filePrinter.append("Sub('" + std::to_string(i) + "'): " + f.name());
+            m_output.print("Sub('", i, "'): ", f->name());
         } else {
-            m_filePrinter.append(", Sub('" + std::to_string(i) + "'): " + f.name());
+            m_output.print(", Sub('", i, "'): ", f->name());
         }
         i += 1;
     }
-    m_filePrinter.append_nl("}");
+    m_output.append_nl("}");
 }
 
 void frac::StructurePrinter::print_space_of_cell(frac::Face const& cell) {
-    m_filePrinter.append("    " + cell.name() + ".space = [");
+    m_output.print("    ", cell.name(), ".space = [");
     for (std::size_t i = 0; i < cell.len(); ++i) {
         if (i == 0) {
-            m_filePrinter.append("Bord_('" + std::to_string(i) + "')");
+            m_output.print("Bord_('", i, "')");
         } else {
-            m_filePrinter.append(", Bord_('" + std::to_string(i) + "')");
+            m_output.print(", Bord_('", i, "')");
         }
     }
-    m_filePrinter.append_nl("]");
+    m_output.append_nl("]");
 }
 
 void frac::StructurePrinter::print_prim_of_cell(frac::Face const& cell) {
-    m_filePrinter.append_nl("    " + cell.name() + ".prim.elems = [Figure(2, [");
+    m_output.println("    ", cell.name(), ".prim.elems = [Figure(2, [");
     for (std::size_t i = 0; i < cell.len(); ++i) {
         if (cell[i].edgeType() == EdgeType::BEZIER && cell[i].delay() == 0) {
             for (std::size_t j = 0; j < cell[i].nbSubdivisions(); ++j) {
                 if (cell[i].nbSubdivisions() > 2) {
-                    m_filePrinter.append_nl("        Bord_('" + std::to_string(i) + "') + Sub('" + std::to_string(j) + "') + Bord('0'),");
+                    m_output.println("        Bord_('", i, "') + Sub('", j, "') + Bord('0'),");
                 } else {
                     for (std::size_t k = 0; k < cell[i].nbSubdivisions(); ++k) {
-                        m_filePrinter.append_nl("        Bord_('" + std::to_string(i) + "') + Sub('" + std::to_string(j) + "') + Sub('" + std::to_string(k) + "') + Bord('0'),");
+                        m_output.println("        Bord_('", i, "') + Sub('", j, "') + Sub('", k, "') + Bord('0'),");
                     }
                 }
             }
         } else {
-            m_filePrinter.append_nl("        Bord_('" + std::to_string(i) + "') + Bord('0'),");
+            m_output.println("        Bord_('", i, "') + Bord('0'),");
         }
     }
-    m_filePrinter.append_nl("    ])]");
+    m_output.append_nl("    ])]");
 }
 
 void frac::StructurePrinter::print_edge_adjacencies_of_cell(frac::Face const& cell) {
     for (std::size_t i = 0; i < cell.len(); ++i) {
-        m_filePrinter.append_nl("    " + cell.name() + "(Bord('" + std::to_string(i) + "') + Bord('1'), Bord('" + std::to_string(utils::mod(i + 1, cell.len())) + "') + Bord('0'))");
+        m_output.println("    ", cell.name(), "(Bord('", i, "') + Bord('1'), Bord('", utils::mod(i + 1, cell.len()), "') + Bord('0'))");
     }
 }
 
@@ -546,88 +312,118 @@ void frac::StructurePrinter::print_plan_control_points() {
     std::size_t max = m_structure.faces().size();
     for (std::size_t index_face = 0; index_face < max; ++index_face) {
         std::size_t nb_pts = m_structure.nbControlPointsOfFace(index_face);
-        m_filePrinter.append_nl("    init.initMat[Sub_('" + std::to_string(index_face) + "')] = FMat([");
+        m_output.println("    init.initMat[Sub_('", index_face, "')] = FMat([");
         for (int j = 0; j < 3; ++j) {
             // x, y, z set to 0
-            m_filePrinter.append("        [");
+            m_output.append("        [");
             for (std::size_t i = 0; i < nb_pts - 1; ++i) {
-                m_filePrinter.append("0, ");
+                m_output.append("0, ");
             }
-            m_filePrinter.append_nl("0],");
+            m_output.append_nl("0],");
         }
         // w
-        m_filePrinter.append("        [");
+        m_output.append("        [");
         for (std::size_t i = 0; i < nb_pts - 1; ++i) {
-            m_filePrinter.append("1, ");
+            m_output.append("1, ");
         }
-        m_filePrinter.append_nl("1]]).setTyp('Var')");
+        m_output.append_nl("1]]).setTyp('Var')");
         // set z as const
-        m_filePrinter.append_nl("    for i in range(init.initMat[Sub_('" + std::to_string(index_face) + "')].n):");
-        m_filePrinter.append_nl("        init.initMat[Sub_('" + std::to_string(index_face) + "')][2, i].setTyp('Const')");
-        m_filePrinter.append_nl("");
+        m_output.println("    for i in range(init.initMat[Sub_('", index_face, "')].n):");
+        m_output.println("        init.initMat[Sub_('", index_face, "')][2, i].setTyp('Const')");
+        m_output.append_nl("");
     }
 }
 
 void frac::StructurePrinter::print_plan_coords_control_points() {
-    for (std::size_t index_face = 0; index_face < m_coords.size(); ++index_face) {
-        std::size_t nb_pts = m_coords[index_face].size();
-        m_filePrinter.append_nl("    init.initMat[Sub_('" + std::to_string(index_face) + "')] = FMat([");
+    for (std::size_t index_face = 0; index_face < m_coords->nbFaces(); ++index_face) {
+        std::size_t nb_pts = m_coords->size(index_face);
+        float const* xs = m_coords->xs(index_face);
+        float const* ys = m_coords->ys(index_face);
+        m_output.println("    init.initMat[Sub_('", index_face, "')] = FMat([");
 
         //x
-        m_filePrinter.append("        [");
+        m_output.append("        [");
         for (std::size_t i = 0; i < nb_pts - 1; ++i) {
-            m_filePrinter.append(frac::utils::to_string(static_cast<float>(m_coords[index_face][i].x())) + ", ");
+            m_output.appendFloat(xs[i], m_floatFormat);
+            m_output.append(", ");
         }
-        m_filePrinter.append_nl(frac::utils::to_string(static_cast<float>(m_coords[index_face][nb_pts - 1].x())) + "],");
+        m_output.appendFloat(xs[nb_pts - 1], m_floatFormat);
+        m_output.append_nl("],");
 
         //y
-        m_filePrinter.append("        [");
+        m_output.append("        [");
         for (std::size_t i = 0; i < nb_pts - 1; ++i) {
-            m_filePrinter.append(frac::utils::to_string(static_cast<float>(m_coords[index_face][i].y())) + ", ");
+            m_output.appendFloat(ys[i], m_floatFormat);
+            m_output.append(", ");
         }
-        m_filePrinter.append_nl(frac::utils::to_string(static_cast<float>(m_coords[index_face][nb_pts - 1].y())) + "],");
+        m_output.appendFloat(ys[nb_pts - 1], m_floatFormat);
+        m_output.append_nl("],");
 
         //z
-        m_filePrinter.append("        [");
+        m_output.append("        [");
         for (std::size_t i = 0; i < nb_pts - 1; ++i) {
-            m_filePrinter.append("0, ");
+            m_output.append("0, ");
         }
-        m_filePrinter.append_nl("0],");
+        m_output.append_nl("0],");
 
         // w
-        m_filePrinter.append("        [");
+        m_output.append("        [");
         for (std::size_t i = 0; i < nb_pts - 1; ++i) {
-            m_filePrinter.append("1, ");
+            m_output.append("1, ");
         }
-        m_filePrinter.append_nl("1]]).setTyp('Var')");
+        m_output.append_nl("1]]).setTyp('Var')");
         // set z as const
-        m_filePrinter.append_nl("    for i in range(init.initMat[Sub_('" + std::to_string(index_face) + "')].n):");
-        m_filePrinter.append_nl("        init.initMat[Sub_('" + std::to_string(index_face) + "')][2, i].setTyp('Const')");
-        m_filePrinter.append_nl("");
+        m_output.println("    for i in range(init.initMat[Sub_('", index_face, "')].n):");
+        m_output.println("        init.initMat[Sub_('", index_face, "')][2, i].setTyp('Const')");
+        m_output.append_nl("");
+    }
+}
+
+void frac::StructurePrinter::print_matrix(frac::MatrixBlob const& matrices, std::size_t index) {
+    m_output.append("[");
+    for (std::uint32_t row = 0; row < matrices.nbRows(index); ++row) {
+        m_output.append(row == 0 ? "[" : ", [");
+        for (std::uint32_t column = 0; column < matrices.nbColumns(index); ++column) {
+            if (column != 0) {
+                m_output.append(", ");
+            }
+            m_output.appendDouble(matrices.value(index, row, column));
+        }
+        m_output.append("]");
     }
+    m_output.append("]");
 }
 
 void frac::StructurePrinter::print_footer() {
-    m_filePrinter.append_nl("    # to save matrices of cells");
-    m_filePrinter.append_nl("    for cell in allCellsToSave:");
-    m_filePrinter.append_nl("        folderpath = cell.name.replace('/', '--')");
-    m_filePrinter.append_nl("        folderpath = os.path.dirname(os.path.abspath(__file__)) + '/library/' + folderpath.replace(' ', '') + '/'");
-    m_filePrinter.append_nl("        os.makedirs(folderpath, exist_ok=True)");
-    m_filePrinter.append_nl("        for i in range(len(cell.subs)-1):");
-    m_filePrinter.append_nl("            filepath = folderpath + str(i)");
-    m_filePrinter.append_nl("            with open(filepath, 'w') as f:");
-    m_filePrinter.append_nl("                f.write(str(cell.fm_[Sub(str(i))].tab))");
-    m_filePrinter.append_nl("");
-    m_filePrinter.append_nl("    return init");
-    m_filePrinter.append_nl("");
-    m_filePrinter.append_nl("");
-    m_filePrinter.append_nl("if __name__ == '__main__':");
-    m_filePrinter.append_nl("    print('modele()')");
-    m_filePrinter.append_nl("    model_init = modele()");
-    m_filePrinter.append_nl("    print('check()')");
-    m_filePrinter.append_nl("    model_init.check()");
-    m_filePrinter.append_nl("    print('solve()')");
-    m_filePrinter.append_nl("    model_init.solve()");
-    m_filePrinter.append_nl("    print('End')");
+    m_output.append_nl("    # to save matrices of cells");
+    m_output.append_nl("    for cell in allCellsToSave:");
+    m_output.append_nl("        key = cell.name.replace('/', '--').replace(' ', '')");
+    m_output.append_nl("        folderpath = os.path.dirname(os.path.abspath(__file__)) + '/library/'");
+    m_output.append_nl("        os.makedirs(folderpath, exist_ok=True)");
+    m_output.append_nl("        # same blob as the library packs, nb of matrices then rows, columns and float64 values of each matrix");
+    m_output.append_nl("        blob = struct.pack('<I', len(cell.subs)-1)");
+    m_output.append_nl("        for i in range(len(cell.subs)-1):");
+    m_output.append_nl("            rows = [[float(v) for v in row] for row in cell.fm_[Sub(str(i))].tab]");
+    m_output.append_nl("            blob += struct.pack('<II', len(rows), len(rows[0]) if rows else 0)");
+    m_output.append_nl("            for row in rows:");
+    m_output.append_nl("                blob += struct.pack('<%dd' % len(row), *row)");
+    m_output.println("        with open(folderpath + key + '", frac::MatrixBlob::s_extension, "', 'wb') as f:");
+    m_output.append_nl("            f.write(blob)");
+    m_output.append_nl("");
+    m_output.append_nl("    return init");
+    m_output.append_nl("");
+    m_output.append_nl("");
+    m_output.append_nl("if __name__ == '__main__':");
+    m_output.append_nl("    print('modele()')");
+    m_output.append_nl("    model_init = modele()");
+    m_output.append_nl("    print('check()')");
+    m_output.append_nl("    model_init.check()");
+    // the constraints of the cells are already solved in their matrices, but the adjacencies of the init cells
+    // still constrain the coordinates of the faces, only the script solves them
+    if (m_solvedMatrices == nullptr || !m_structure.adjacencies().empty()) {
+        m_output.append_nl("    print('solve()')");
+        m_output.append_nl("    model_init.solve()");
+    }
+    m_output.append_nl("    print('End')");
 }
 
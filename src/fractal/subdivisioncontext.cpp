@@ -0,0 +1,238 @@
+#include "fractal/subdivisioncontext.h"
+#include "utils/utils.h"
+#include "fractal/algorithms/algorithmsurrounddelayandbezier.h"
+#include "fractal/algorithms/algorithmsurrounddelay.h"
+#include "fractal/algorithms/algorithmoncorners.h"
+
+#include <algorithm>
+#include <cassert>
+#include <thread>
+
+frac::SubdivisionContext::SubdivisionContext() : m_nbThreads(std::max(1u, std::thread::hardware_concurrency())) {}
+
+frac::SubdivisionContext::SubdivisionContext(frac::SubdivisionContext const* parent) :
+        m_parent(parent), m_firstId(parent->nbCells()), m_nbThreads(1) {}
+
+std::optional<std::size_t> frac::SubdivisionContext::findCell(frac::FaceKey const& key) const {
+    if (m_parent != nullptr) {
+        std::optional<std::size_t> id = m_parent->findCell(key);
+        if (id.has_value()) {
+            return id;
+        }
+    }
+    auto it = m_ids.find(key);
+    if (it == m_ids.end()) {
+        return {};
+    }
+    return it->second;
+}
+
+std::size_t frac::SubdivisionContext::addCell(frac::FaceKey key, frac::Face const& face) {
+    std::size_t id = this->nbCells();
+    m_ids.emplace(std::move(key), id);
+    m_cells.push_back(face);
+    m_names.emplace_back();
+    m_strings.emplace_back();
+    m_incidenceRanges.emplace_back(m_incidenceConstraints.size(), m_incidenceConstraints.size());
+    m_adjacencyRanges.emplace_back(m_adjacencyConstraints.size(), m_adjacencyConstraints.size());
+    m_subdivisions.emplace_back();
+    return id;
+}
+
+frac::Face const& frac::SubdivisionContext::cell(std::size_t id) const {
+    if (id < m_firstId) {
+        return m_parent->cell(id);
+    }
+    return m_cells[id - m_firstId];
+}
+
+std::size_t frac::SubdivisionContext::nbCells() const {
+    return m_firstId + m_cells.size();
+}
+
+std::string& frac::SubdivisionContext::cachedString(std::vector<std::string>& cache, std::unordered_map<std::size_t, std::string>& parentCache, std::size_t id) {
+    // a staging context keeps its own strings for the cells of its parent, the parent is only read
+    if (id < m_firstId) {
+        return parentCache[id];
+    }
+    return cache[id - m_firstId];
+}
+
+std::string const& frac::SubdivisionContext::cellName(std::size_t id) {
+    std::string& name = this->cachedString(m_names, m_parentNames, id);
+    if (name.empty()) {
+        Face const& f = this->cell(id);
+        name = "Cell_" + std::to_string(id);
+        if (f.delay() != 0) {
+            // one face if delayed, with subdivided boundaries
+            // add delay info to name
+            name += "_" + std::to_string(f.delay());
+        }
+    }
+    return name;
+}
+
+std::string const& frac::SubdivisionContext::cellString(std::size_t id) {
+    std::string& res = this->cachedString(m_strings, m_parentStrings, id);
+    if (!res.empty()) {
+        return res;
+    }
+    Face const& f = this->cell(id);
+    res = f[0].toString();
+    for (std::size_t i = 1; i < f.len(); ++i) {
+        res += " - " + f[i].toString();
+    }
+    res += " / ";
+
+    res += f.adjEdge().toString() + " - ";
+    res += f.gapEdge().toString() + " - ";
+    res += f.reqEdge().toString() + " / ";
+    res += std::to_string(f.delay()) + " / ";
+    res += std::to_string(static_cast<int>(f.algo()));
+    return res;
+}
+
+std::vector<frac::Face> const& frac::SubdivisionContext::subdivisions(std::size_t id) {
+    if (id < m_firstId) {
+        // a staging context cannot subdivide the cells of its parent, only read the known subdivisions
+        assert(m_parent->hasSubdivisions(id));
+        m_subdivisionsHits++;
+        return m_parent->knownSubdivisions(id);
+    }
+    std::optional<std::vector<frac::Face>>& subs = m_subdivisions[id - m_firstId];
+    if (subs.has_value()) {
+        m_subdivisionsHits++;
+        return subs.value();
+    }
+    // the constraints staged for a cell are the ones of the cell given to stageSubdivisions only
+    assert(m_parent == nullptr);
+    m_subdivisionsMisses++;
+    // the cell is subdivided from the face that created it, so its subdivisions
+    // do not depend on which face of the cell asked for them first
+    // copy it since subdividing adds cells to m_cells
+    Face const face = m_cells[id];
+    std::vector<frac::Face> res = SubdivisionContext::subdivide(face, *this);
+    return subs.emplace(std::move(res));
+}
+
+bool frac::SubdivisionContext::hasSubdivisions(std::size_t id) const {
+    if (id < m_firstId) {
+        return m_parent->hasSubdivisions(id);
+    }
+    return m_subdivisions[id - m_firstId].has_value();
+}
+
+std::vector<frac::Face> const& frac::SubdivisionContext::knownSubdivisions(std::size_t id) const {
+    if (id < m_firstId) {
+        return m_parent->knownSubdivisions(id);
+    }
+    return m_subdivisions[id - m_firstId].value();
+}
+
+std::unique_ptr<frac::SubdivisionContext> frac::SubdivisionContext::stageSubdivisions(std::size_t id) const {
+    std::unique_ptr<SubdivisionContext> staging(new SubdivisionContext(this));
+    staging->m_stagedSubdivisions = SubdivisionContext::subdivide(this->cell(id), *staging);
+    return staging;
+}
+
+std::vector<frac::Face> const& frac::SubdivisionContext::commitSubdivisions(std::size_t id, frac::SubdivisionContext const& staging) {
+    // the staged cells are interned again, so only in the context that owns them
+    assert(m_parent == nullptr);
+    m_subdivisionsMisses++;
+    Face const face = m_cells[id];
+    // intern the staged faces again, a cell staged as new may have been added since, by another cell
+    std::vector<frac::Face> res;
+    res.reserve(staging.m_stagedSubdivisions.size());
+    for (Face const& f: staging.m_stagedSubdivisions) {
+        res.emplace_back(*this, f.constData(), f.delay(), f.adjEdge(), f.gapEdge(), f.reqEdge(), f.algo());
+        res.back().setFirstInterior(f.firstInterior());
+    }
+    // the algorithms always give the face at the index of the sub face, so it is found back in res
+    for (StagedConstraint const& c: staging.m_stagedConstraints) {
+        unsigned int const* i = c.indices;
+        if (c.adjacency) {
+            this->addAdjacencyConstraint(face, res[i[0]], res[i[2]], i[0], i[1], i[2], i[3]);
+        } else {
+            this->addIncidenceConstraint(face, res[i[3]], i[0], i[1], i[2], i[3]);
+        }
+    }
+    return m_subdivisions[id].emplace(std::move(res));
+}
+
+std::vector<frac::Face> frac::SubdivisionContext::subdivide(frac::Face const& face, frac::SubdivisionContext& context) {
+    switch (face.algo()) {
+        case AlgorithmSubdivision::LinksSurroundDelay:
+            return frac::LinksSurroundDelay::subdivide(face, context);
+        case AlgorithmSubdivision::LinksSurroundDelayAndBezier:
+            return frac::LinksSurroundDelayAndBezier::subdivide(face, context);
+        case AlgorithmSubdivision::LinksOnCorners:
+            return frac::LinksOnCorners::subdivide(face, context);
+    }
+    return {};
+}
+
+std::size_t frac::SubdivisionContext::subdivisionsHits() const {
+    return m_subdivisionsHits;
+}
+
+std::size_t frac::SubdivisionContext::subdivisionsMisses() const {
+    return m_subdivisionsMisses;
+}
+
+void frac::SubdivisionContext::addAdjacencyConstraint(frac::Face const& face, frac::Face const& faceSub1, frac::Face const& faceSub2, unsigned int indexSubFace1, unsigned int indexBordFace1, unsigned int indexSubFace2, unsigned int indexBordFace2) {
+    if (m_parent != nullptr) {
+        m_stagedConstraints.push_back({ true, { indexSubFace1, indexBordFace1, indexSubFace2, indexBordFace2 }});
+        return;
+    }
+    auto s1 = static_cast<std::uint32_t>(indexSubFace1);
+    auto b1 = static_cast<std::uint32_t>(frac::utils::mod(static_cast<int>(indexBordFace1) - static_cast<int>(faceSub1.offset()), static_cast<int>(faceSub1.len())));
+    auto s2 = static_cast<std::uint32_t>(indexSubFace2);
+    auto b2 = static_cast<std::uint32_t>(frac::utils::mod(static_cast<int>(indexBordFace2) - static_cast<int>(faceSub2.offset()), static_cast<int>(faceSub2.len())));
+    std::pair<std::size_t, std::size_t>& range = m_adjacencyRanges[face.id()];
+    if (range.first == range.second) {
+        range = { m_adjacencyConstraints.size(), m_adjacencyConstraints.size() };
+    }
+    m_adjacencyConstraints.push_back({ static_cast<std::uint32_t>(face.id()), s1, b1, 0, s2, b2 });
+    range.second++;
+}
+
+void frac::SubdivisionContext::addIncidenceConstraint(frac::Face const& face, frac::Face const& faceSub, unsigned int indexParentEdge, unsigned int indexSubEdge, unsigned int indexSubFaceEdge, unsigned int indexSubFace) {
+    if (m_parent != nullptr) {
+        m_stagedConstraints.push_back({ false, { indexParentEdge, indexSubEdge, indexSubFaceEdge, indexSubFace }});
+        return;
+    }
+    auto b1 = static_cast<std::uint32_t>(frac::utils::mod(static_cast<int>(indexParentEdge) - static_cast<int>(face.offset()), static_cast<int>(face.len())));
+    auto s1 = static_cast<std::uint32_t>(indexSubEdge);
+    auto s2 = static_cast<std::uint32_t>(indexSubFace);
+    auto b2 = static_cast<std::uint32_t>(frac::utils::mod(static_cast<int>(indexSubFaceEdge) - static_cast<int>(faceSub.offset()), static_cast<int>(faceSub.len())));
+    std::pair<std::size_t, std::size_t>& range = m_incidenceRanges[face.id()];
+    if (range.first == range.second) {
+        range = { m_incidenceConstraints.size(), m_incidenceConstraints.size() };
+    }
+    m_incidenceConstraints.push_back({ static_cast<std::uint32_t>(face.id()), b1, s1, s2, b2 });
+    range.second++;
+}
+
+frac::Span<frac::IncidenceConstraint const> frac::SubdivisionContext::incidenceConstraints(std::size_t id) const {
+    if (id < m_firstId) {
+        return m_parent->incidenceConstraints(id);
+    }
+    std::pair<std::size_t, std::size_t> const& range = m_incidenceRanges[id - m_firstId];
+    return { m_incidenceConstraints.data() + range.first, m_incidenceConstraints.data() + range.second };
+}
+
+frac::Span<frac::AdjacencyConstraint const> frac::SubdivisionContext::adjacencyConstraints(std::size_t id) const {
+    if (id < m_firstId) {
+        return m_parent->adjacencyConstraints(id);
+    }
+    std::pair<std::size_t, std::size_t> const& range = m_adjacencyRanges[id - m_firstId];
+    return { m_adjacencyConstraints.data() + range.first, m_adjacencyConstraints.data() + range.second };
+}
+
+void frac::SubdivisionContext::setNbThreads(unsigned int nbThreads) {
+    m_nbThreads = std::max(1u, nbThreads);
+}
+
+unsigned int frac::SubdivisionContext::nbThreads() const {
+    return m_nbThreads;
+}
@@ -0,0 +1,64 @@
+#include "fractal/subdivisiongraph.h"
+#include "fractal/closureengine.h"
+#include "fractal/subdivisioncontext.h"
+
+frac::SubdivisionGraph::SubdivisionGraph(frac::SubdivisionContext& context, std::vector<frac::Face> const& roots) {
+    m_cells = frac::ClosureEngine(context).closure(roots).data();
+
+    m_indices.resize(context.nbCells());
+    for (std::size_t i = 0; i < m_cells.size(); ++i) {
+        m_indices[m_cells[i].id()] = i;
+    }
+
+    m_childOffsets.reserve(m_cells.size() + 1);
+    m_childOffsets.push_back(0);
+    for (frac::Face const& c: m_cells) {
+        for (frac::Face const& f: context.subdivisions(c.id())) {
+            m_children.push_back(f);
+            m_childIndices.push_back(m_indices[f.id()]);
+        }
+        m_childOffsets.push_back(m_children.size());
+    }
+
+    for (frac::Face const& c: m_cells) {
+        for (frac::Edge const& e: c.constData()) {
+            m_edges.add(e);
+        }
+    }
+}
+
+std::vector<frac::Face> const& frac::SubdivisionGraph::cells() const {
+    return m_cells;
+}
+
+std::size_t frac::SubdivisionGraph::nbCells() const {
+    return m_cells.size();
+}
+
+frac::Face const& frac::SubdivisionGraph::cell(std::size_t index) const {
+    return m_cells[index];
+}
+
+std::size_t frac::SubdivisionGraph::indexOf(frac::Face const& face) const {
+    return m_indices[face.id()];
+}
+
+std::size_t frac::SubdivisionGraph::nbChildren(std::size_t index) const {
+    return m_childOffsets[index + 1] - m_childOffsets[index];
+}
+
+frac::Face const* frac::SubdivisionGraph::childrenBegin(std::size_t index) const {
+    return m_children.data() + m_childOffsets[index];
+}
+
+frac::Face const* frac::SubdivisionGraph::childrenEnd(std::size_t index) const {
+    return m_children.data() + m_childOffsets[index + 1];
+}
+
+std::size_t frac::SubdivisionGraph::childIndex(std::size_t index, std::size_t k) const {
+    return m_childIndices[m_childOffsets[index] + k];
+}
+
+frac::Set<frac::Edge> const& frac::SubdivisionGraph::edges() const {
+    return m_edges;
+}
@@ -0,0 +1,138 @@
+#include "fractal/subdivisionmatrices.h"
+#include "fractal/edge.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+
+// s_binomials[n][k] is n choose k
+constexpr auto computeBinomials() {
+    std::array<std::array<double, frac::s_maxDegree + 1>, frac::s_maxDegree + 1> res {};
+    for (unsigned int n = 0; n <= frac::s_maxDegree; n++) {
+        res[n][0] = 1;
+        for (unsigned int k = 1; k <= n; k++) {
+            res[n][k] = res[n - 1][k - 1] + res[n - 1][k];
+        }
+    }
+    return res;
+}
+
+constexpr auto s_binomials = computeBinomials();
+
+constexpr double power(double base, unsigned int exponent) {
+    double res = 1;
+    for (unsigned int e = 0; e < exponent; e++) {
+        res *= base;
+    }
+    return res;
+}
+
+// the jth control point of the piece [a, b] of the curve, the result of de casteljau's algorithm, is the blossom
+// of the curve at a repeated Degree - j times and b repeated j times, the weight of the rth control point of the
+// curve is the sum over k of the products of bernstein factors where k of the r chosen arguments are b
+// a = i / n and b = (i + 1) / n so each weight is an integer over n^Degree, exact for the usual n
+template<unsigned int Degree>
+constexpr typename frac::SubdivisionMatrices<Degree>::Matrix computeMatrix(unsigned int i, unsigned int n) {
+    typename frac::SubdivisionMatrices<Degree>::Matrix res {};
+    double denominator = power(n, Degree);
+    for (unsigned int r = 0; r <= Degree; r++) {
+        for (unsigned int j = 0; j <= Degree; j++) {
+            double numerator = 0;
+            for (unsigned int k = r > Degree - j ? r - (Degree - j) : 0; k <= std::min(r, j); k++) {
+                numerator += s_binomials[Degree - j][r - k] * s_binomials[j][k]
+                             * power(i, r - k) * power(n - i, Degree - j - (r - k))
+                             * power(i + 1, k) * power(n - i - 1, j - k);
+            }
+            res[r * (Degree + 1) + j] = static_cast<float>(numerator) / static_cast<float>(denominator);
+        }
+    }
+    return res;
+}
+
+// matrices of n pieces for n in [1, s_maxPrecomputed], those of n start at n * (n - 1) / 2
+template<unsigned int Degree>
+constexpr auto precomputeMatrices() {
+    constexpr unsigned int max = frac::SubdivisionMatrices<Degree>::s_maxPrecomputed;
+    std::array<typename frac::SubdivisionMatrices<Degree>::Matrix, max * (max + 1) / 2> table {};
+    std::size_t k = 0;
+    for (unsigned int n = 1; n <= max; n++) {
+        for (unsigned int i = 0; i < n; i++) {
+            table[k++] = computeMatrix<Degree>(i, n);
+        }
+    }
+    return table;
+}
+
+template<unsigned int Degree>
+constexpr auto s_precomputedMatrices = precomputeMatrices<Degree>();
+
+// values of the matrix of piece i of n of a bezier curve of the degree, row by row, from the degree Degree
+template<unsigned int Degree = 2>
+void copyPieceMatrix(unsigned int degree, unsigned int n, unsigned int i, std::vector<double>& values) {
+    if constexpr (Degree <= frac::s_maxDegree) {
+        if (degree != Degree) {
+            copyPieceMatrix<Degree + 1>(degree, n, i, values);
+            return;
+        }
+        auto const& matrix = frac::SubdivisionMatrices<Degree>::get(n)[i];
+        values.assign(matrix.begin(), matrix.end());
+    }
+}
+
+}
+
+template<unsigned int Degree>
+frac::Span<typename frac::SubdivisionMatrices<Degree>::Matrix const> frac::SubdivisionMatrices<Degree>::get(unsigned int n) {
+    if (n == 0) {
+        return {};
+    }
+    if (n <= s_maxPrecomputed) {
+        Matrix const* first = s_precomputedMatrices<Degree>.data() + n * (n - 1) / 2;
+        return { first, first + n };
+    }
+
+    // printers of different jobs may ask at the same time
+    static std::mutex mutex;
+    static std::unordered_map<unsigned int, std::unique_ptr<Matrix[]>> computed;
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unique_ptr<Matrix[]>& matrices = computed[n];
+    if (matrices == nullptr) {
+        matrices = std::make_unique<Matrix[]>(n);
+        for (unsigned int i = 0; i < n; i++) {
+            matrices[i] = computeMatrix<Degree>(i, n);
+        }
+    }
+    return { matrices.get(), matrices.get() + n };
+}
+
+std::vector<double> frac::edgePieceMatrix(frac::Edge const& edge, unsigned int degree, unsigned int sub) {
+    std::vector<double> res;
+    if (edge.isDelay()) {
+        // the only piece of a delayed edge is the edge
+        res.assign((degree + 1) * (degree + 1), 0.0);
+        for (unsigned int j = 0; j <= degree; j++) {
+            res[j * (degree + 1) + j] = 1.0;
+        }
+    } else if (edge.edgeType() == frac::EdgeType::BEZIER) {
+        copyPieceMatrix(degree, edge.nbSubdivisions(), sub, res);
+    } else if (degree == 1) {
+        // the pieces of a classic cantor edge are one over two segments of the edge cut in 2n - 1
+        double m = 2.0 * edge.nbSubdivisions() - 1.0;
+        double t0 = 2.0 * sub / m;
+        double t1 = (2.0 * sub + 1.0) / m;
+        res = { 1.0 - t0, 1.0 - t1, t0, t1 };
+    } else {
+        copyPieceMatrix(degree, 2 * edge.nbSubdivisions() - 1, 2 * sub, res);
+    }
+    return res;
+}
+
+template class frac::SubdivisionMatrices<2>;
+template class frac::SubdivisionMatrices<3>;
+template class frac::SubdivisionMatrices<4>;
+template class frac::SubdivisionMatrices<5>;
+template class frac::SubdivisionMatrices<6>;
+template class frac::SubdivisionMatrices<7>;
@@ -1,16 +1,13 @@
+#include <algorithm>
 #include <iostream>
-#include <fstream>
-#include "fractal/face.h"
-#include "fractal/structure.h"
-#include "fractal/structureprinter.h"
-#include "utils/point2d.h"
-#include "utils/utils.h"
-
-enum Mode {
-    FACE,
-    CONSTRAINT,
-    COORD
-};
+#include <thread>
+#include "fractal/binaryformat.h"
+#include "fractal/edge.h"
+#include "fractal/inputreader.h"
+#include "fractal/job.h"
+#include "fractal/subdivisioncontext.h"
+#include "utils/librarypack.h"
+#include "utils/workstealingpool.h"
 
 bool optionExists(int argc, char* argv[], std::string const& option) {
     bool res = false;
@@ -33,163 +30,182 @@ std::string getCmdOption(int argc, char* argv[], std::string const& option) {
 }
 
 void printHelp() {
-    std::cout << "usage: ./AutoFrac2DCli [-a] [-c] [-i N] [-l path] filename" << std::endl;
-    std::cout << "\tfilename\t\t path to the input file" << std::endl;
+    std::cout << "usage: ./AutoFrac2DCli [-a] [-c] [-d N] [-e N] [-g N] [-i N] [-j N] [-l path] [-o path] [-p format] [-s] [-x] [-b path] [-k path] [-m] filename" << std::endl;
+    std::cout << "\tfilename\t\t path to the input file, text or binary" << std::endl;
     std::cout << "\t-a      \t\t automatic position of intern control points" << std::endl;
     std::cout << "\t-c      \t\t use cubic bezier curves, default is quadratic" << std::endl;
+    std::cout << "\t-d N    \t\t degree of the bezier curves, from 2 to " << frac::s_maxDegree << ", -c is -d 3" << std::endl;
+    std::cout << "\t-e N    \t\t degree of the cantor curves, from 1 to " << frac::s_maxDegree << ", default is 1, the classic cantor" << std::endl;
+    std::cout << "\t-g N    \t\t write N points of the attractor to the output instead of the script, needs -o, the matrices are the ones of the library or of -s or -x" << std::endl;
     std::cout << "\t-i N    \t\t nb iterations of subdivision points, default is 0" << std::endl;
-    std::cout << "\t-l path \t\t path to the lib folder with an end '/', default is \"library/\"" << std::endl;
+    std::cout << "\t-j N    \t\t nb threads used to compute the subdivisions, or to run the jobs with -m, at most " << frac::WorkStealingPool::s_maxThreads << ", default is the nb of hardware threads" << std::endl;
+    std::cout << "\t-l path \t\t path to the lib folder with an end '/' or to a library pack, default is \"library/\"" << std::endl;
+    std::cout << "\t-o path \t\t path to the output python file, '-' for the standard output, default is \"output.py\"" << std::endl;
+    std::cout << "\t-p format\t\t format of the floats, a nb of digits after the point or 'shortest' to read back the same floats, default is 4" << std::endl;
+    std::cout << "\t-s      \t\t place the subdivision points with the spring–mass system of the cli, -i is then unused" << std::endl;
+    std::cout << "\t-x      \t\t solve the constraints with the cli from the library or -s, save the solved matrices in the library folder" << std::endl;
+    std::cout << "\t-b path \t\t only convert the input file to the binary format at path" << std::endl;
+    std::cout << "\t-k path \t\t only pack the library folder filename into the library pack at path" << std::endl;
+    std::cout << "\t-m      \t\t filename is a manifest, each line is 'input output [-a] [-c] [-d N] [-e N] [-g N] [-i N] [-j N] [-l path] [-p format] [-s] [-x]'" << std::endl;
+}
+
+// value of a count option, only digits, false if it is not or if it does not fit an unsigned int
+bool parseCount(std::string const& str, unsigned int& value) {
+    if (str.empty() || str.size() > 9 || str.find_first_not_of("0123456789") != std::string::npos) {
+        return false;
+    }
+    value = static_cast<unsigned int>(std::stoul(str));
+    return true;
 }
 
 int main(int argc, char* argv[]) {
     std::string filename = argv[argc - 1];
     bool autoCoord = optionExists(argc, argv, "-a");
     bool cubicBezier = optionExists(argc, argv, "-c");
+    bool degreeSet = optionExists(argc, argv, "-d");
+    bool cantorDegreeSet = optionExists(argc, argv, "-e");
+    bool samplePoints = optionExists(argc, argv, "-g");
     bool iterAutoSubs = optionExists(argc, argv, "-i");
+    bool nbThreadsSet = optionExists(argc, argv, "-j");
     bool libPath = optionExists(argc, argv, "-l");
-    unsigned int nbIterAutoSubs = iterAutoSubs ? std::stoul(getCmdOption(argc, argv, "-i")) : 0;
+    bool outputPath = optionExists(argc, argv, "-o");
+    bool floatFormatSet = optionExists(argc, argv, "-p");
+    bool solveSubs = optionExists(argc, argv, "-s");
+    bool solveConstraints = optionExists(argc, argv, "-x");
+    bool toBinary = optionExists(argc, argv, "-b");
+    bool toPack = optionExists(argc, argv, "-k");
+    bool manifest = optionExists(argc, argv, "-m");
+    unsigned int nbIterAutoSubs = 0;
+    bool nbIterAutoSubsValid = !iterAutoSubs || parseCount(getCmdOption(argc, argv, "-i"), nbIterAutoSubs);
     std::string libraryPath = libPath ? getCmdOption(argc, argv, "-l") : "library/";
+    std::string output = outputPath ? getCmdOption(argc, argv, "-o") : "output.py";
 
-    int expectedParams = 1 + (autoCoord ? 1 : 0) + (cubicBezier ? 1 : 0) + (iterAutoSubs ? 2 : 0) + (libPath ? 2 : 0) + 1;
+    int expectedParams = 1 + (autoCoord ? 1 : 0) + (cubicBezier ? 1 : 0) + (degreeSet ? 2 : 0) + (cantorDegreeSet ? 2 : 0) + (samplePoints ? 2 : 0) + (iterAutoSubs ? 2 : 0) + (nbThreadsSet ? 2 : 0) + (libPath ? 2 : 0) + (outputPath ? 2 : 0) + (floatFormatSet ? 2 : 0) + (solveSubs ? 1 : 0) + (solveConstraints ? 1 : 0) + (toBinary ? 2 : 0) + (toPack ? 2 : 0) + (manifest ? 1 : 0) + 1;
 
-    if (expectedParams != argc) {
+    unsigned int bezierDegree = cubicBezier ? 3 : 2;
+    if (degreeSet) {
+        std::string degree = getCmdOption(argc, argv, "-d");
+        bezierDegree = degree.size() == 1 && degree[0] >= '2' && degree[0] <= '9' ? static_cast<unsigned int>(degree[0] - '0') : 0;
+    }
+    unsigned int cantorDegree = 1;
+    if (cantorDegreeSet) {
+        std::string degree = getCmdOption(argc, argv, "-e");
+        cantorDegree = degree.size() == 1 && degree[0] >= '1' && degree[0] <= '9' ? static_cast<unsigned int>(degree[0] - '0') : 0;
+    }
+    frac::FloatFormat floatFormat;
+    // a nb of points is only digits, as in the manifests, and small enough for std::stoull
+    std::string nbPoints = samplePoints ? getCmdOption(argc, argv, "-g") : "0";
+    bool nbPointsValid = !nbPoints.empty() && nbPoints.size() <= 19 && nbPoints.find_first_not_of("0123456789") == std::string::npos;
+
+    // the default output is a script, the points need their own file
+    // the nb of threads is clamped, the pool would not start more
+    unsigned int nbThreads = 0;
+    bool nbThreadsValid = !nbThreadsSet || parseCount(getCmdOption(argc, argv, "-j"), nbThreads);
+    nbThreads = std::min(nbThreads, frac::WorkStealingPool::s_maxThreads);
+
+    if (expectedParams != argc || !nbPointsValid || !nbThreadsValid || !nbIterAutoSubsValid || (samplePoints && !outputPath) || bezierDegree < 2 || bezierDegree > frac::s_maxDegree || cantorDegree < 1 || cantorDegree > frac::s_maxDegree || (floatFormatSet && !frac::FloatFormat::fromStr(getCmdOption(argc, argv, "-p"), floatFormat))) {
         printHelp();
         return 1;
     }
 
-    if (cubicBezier) {
-        std::cout << "Cubic Bezier, ";
-    } else {
-        std::cout << "Quadratic Bezier, ";
-    }
-
-    if (autoCoord) {
-        std::cout << "Intern points auto, ";
-    } else {
-        std::cout << "Intern points not auto, ";
+    if (toPack) {
+        std::string packPath = getCmdOption(argc, argv, "-k");
+        std::vector<frac::LibraryPack::Entry> entries;
+        std::string error;
+        if (!frac::LibraryPack::readFolder(filename, entries, error) || !frac::LibraryPack::write(packPath, entries, error)) {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+        std::cout << entries.size() << " cells packed to file " << packPath << std::endl;
+        return 0;
     }
 
-    std::cout << nbIterAutoSubs << " iterations of spring–mass system, library path " << libraryPath << ", file " << filename << std::endl;
-
-    std::vector<frac::Face> faces;
-    std::vector<frac::Adjacency> constraints;
-    std::vector<frac::Point2D> readCoords;
-    std::vector<std::vector<frac::Point2D>> coords;
-
-    Mode mode = FACE;
-
-    std::ifstream file(filename);
-    std::string line;
-    while (std::getline(file, line)) {
-        if (line.at(0) == 'f') {
-            mode = FACE;
-            continue;
+    if (manifest) {
+        std::vector<frac::JobOptions> jobs;
+        std::string error;
+        if (!frac::readManifest(filename, jobs, error)) {
+            std::cerr << error << std::endl;
+            return 1;
         }
-        if (line.at(0) == 'c') {
-            mode = CONSTRAINT;
-            continue;
-        }
-        if (line.at(0) == 'p') {
-            mode = COORD;
-            continue;
-        }
-        if (line.at(0) == '#') {
-            continue;
-        }
-
-        switch (mode) {
-            case FACE:
-                faces.emplace_back(frac::Face::fromStr(line));
-                break;
-            case CONSTRAINT:
-                constraints.emplace_back(frac::Adjacency::fromStr(line));
-                break;
-            case COORD:
-                std::vector<std::string> words = frac::utils::split(line, " ");
-                readCoords.emplace_back(std::stof(words[0]), std::stof(words[1]));
-                break;
+        std::vector<frac::JobResult> results = frac::runJobs(jobs, nbThreadsSet ? nbThreads : std::max(1u, std::thread::hardware_concurrency()));
+        int status = 0;
+        for (std::size_t i = 0; i < jobs.size(); i++) {
+            std::cout << jobs[i].input << " -> " << jobs[i].output << ": ";
+            if (results[i].success) {
+                std::cout << results[i].nbCellStates << " cell states, " << results[i].nbEdgeStates << " edge states";
+                if (results[i].nbPoints != 0) {
+                    std::cout << ", " << results[i].nbPoints << " points";
+                }
+                if (jobs[i].solveConstraints) {
+                    std::cout << ", constraints residual " << results[i].constraintsResidual;
+                }
+            } else {
+                std::cout << results[i].error;
+                status = 1;
+            }
+            std::cout << ", " << results[i].seconds << " s" << std::endl;
         }
+        return status;
     }
 
-    for (frac::Face const& f: faces) {
-        std::cout << f.name() << std::endl;
-    }
+    // the standard output is kept for the script when it is the output
+    std::ostream& log = output == "-" ? std::cerr : std::cout;
 
-    frac::Structure structure(faces, cubicBezier ? frac::BezierType::Cubic_Bezier : frac::BezierType::Quadratic_Bezier, frac::CantorType::Classic_Cantor);
-    for (frac::Adjacency const& adj: constraints) {
-        structure.addAdjacency(adj);
+    if (bezierDegree == 3) {
+        log << "Cubic Bezier, ";
+    } else if (bezierDegree == 2) {
+        log << "Quadratic Bezier, ";
+    } else {
+        log << "Bezier of degree " << bezierDegree << ", ";
     }
 
-    //fill coordinates
-    std::size_t currentReadCoord = 0;
-    for (std::size_t i = 0; i < faces.size(); i++) {
-        coords.emplace_back();
-        for (std::size_t j = 0; j < faces[i].constData().size(); j++) {
-            coords[i].emplace_back(readCoords[currentReadCoord]);
-            currentReadCoord++;
-            if (faces[i][j].edgeType() == frac::EdgeType::BEZIER) {
-                if (autoCoord) {
-                    if (cubicBezier) {
-                        coords[i].emplace_back(); // emplace default coord for intern control point, will be better placed after
-                    }
-                    coords[i].emplace_back(); // emplace default coord for intern control point, will be better placed after
-                } else {
-                    if (cubicBezier) {
-                        coords[i].emplace_back(readCoords[currentReadCoord]);
-                        currentReadCoord++;
-                    }
-                    coords[i].emplace_back(readCoords[currentReadCoord]);
-                    currentReadCoord++;
-                }
-            }
-        }
+    if (cantorDegree != 1) {
+        log << "Cantor of degree " << cantorDegree << ", ";
     }
 
-    //fill intern control points coordinates
     if (autoCoord) {
-        for (std::size_t i = 0; i < faces.size(); i++) {
-            int nbCtrlPts = static_cast<int>(coords[i].size());
-            bool firstInternCP = true;
-            for (int j = 0; j < static_cast<int>(coords[i].size()); j++) {
-                if (structure.isInternControlPoint(j, i)) {
-                    if (structure.bezierType() == frac::BezierType::Cubic_Bezier) {
-                        if (firstInternCP) {
-                            frac::Point2D P0 = coords[i][j - 1];
-                            frac::Point2D P1 = coords[i][(j + 2) % nbCtrlPts];
-                            frac::Point2D c = frac::utils::coordOfPointOnLineAt(1.f / 3.f, P0, P1);
-                            coords[i][j] = c;
-                            firstInternCP = false;
-                        } else {
-                            frac::Point2D P0 = coords[i][j - 2];
-                            frac::Point2D P1 = coords[i][(j + 1) % nbCtrlPts];
-                            frac::Point2D c = frac::utils::coordOfPointOnLineAt(2.f / 3.f, P0, P1);
-                            coords[i][j] = c;
-                            firstInternCP = true;
-                        }
-                    } else {
-                        coords[i][j] = (coords[i][j - 1] + coords[i][(j + 1) % nbCtrlPts]) / 2.0f;
-                    }
-                }
-            }
-        }
+        log << "Intern points auto, ";
+    } else {
+        log << "Intern points not auto, ";
     }
 
-    //shift coordinates of control points for faces with an offset
-    for (std::size_t i = 0; i < faces.size(); i++) {
-        std::size_t offset = faces[i].offset();
-        for (std::size_t j = 0; j < offset; j++) {
-            coords[i] = frac::utils::shiftVector(coords[i]);
-            if (faces[i][j].edgeType() == frac::EdgeType::BEZIER) {
-                coords[i] = frac::utils::shiftVector(coords[i]);
-                if (structure.bezierType() == frac::BezierType::Cubic_Bezier) {
-                    coords[i] = frac::utils::shiftVector(coords[i]);
-                }
-            }
+    log << nbIterAutoSubs << " iterations of spring–mass system, library path " << libraryPath << ", file " << filename << std::endl;
+
+    if (toBinary) {
+        frac::SubdivisionContext context;
+        frac::InputReader reader(context);
+        if (!reader.read(filename)) {
+            std::cerr << reader.error() << std::endl;
+            return 1;
+        }
+        std::string binaryPath = getCmdOption(argc, argv, "-b");
+        std::string error;
+        if (!frac::BinaryFormat::write(binaryPath, reader.faces(), reader.constraints(), reader.coords(), error)) {
+            std::cerr << error << std::endl;
+            return 1;
         }
+        std::cout << "Structure converted to file " << binaryPath << std::endl;
+        return 0;
     }
 
-    frac::StructurePrinter printer(structure, true, "output.py", nbIterAutoSubs, libraryPath, coords);
-    printer.exportStruct();
-    std::cout << "Structure exported to file output.py" << std::endl;
+    frac::JobOptions options;
+    options.input = filename;
+    options.output = output;
+    options.autoCoord = autoCoord;
+    options.bezierDegree = bezierDegree;
+    options.cantorDegree = cantorDegree;
+    options.nbIterAutoSubs = nbIterAutoSubs;
+    options.solveSubs = solveSubs;
+    options.solveConstraints = solveConstraints;
+    options.nbPoints = std::stoull(nbPoints);
+    options.libraryPath = libraryPath;
+    options.floatFormat = floatFormat;
+    options.nbThreads = nbThreads;
+    frac::LibraryIndex library;
+    frac::JobResult result = frac::runJob(options, library, log);
+    if (!result.success) {
+        std::cerr << result.error << std::endl;
+        return 1;
+    }
     return 0;
 }
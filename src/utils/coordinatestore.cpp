@@ -0,0 +1,90 @@
+#include "utils/coordinatestore.h"
+
+#include <algorithm>
+
+namespace {
+
+// nb of placements computed before they are written, small enough to stay in the l1 cache
+constexpr std::size_t s_chunkSize = 256;
+
+// the points of a chunk are computed without branches in contiguous arrays, which the compiler vectorizes,
+// then written at their targets
+void placeChunk(float* __restrict xs, float* __restrict ys, std::uint32_t const* __restrict targets, std::uint32_t const* __restrict prevs,
+                std::uint32_t const* __restrict nexts, float const* __restrict ts, std::size_t nbPlacements) {
+    float placedXs[s_chunkSize];
+    float placedYs[s_chunkSize];
+    for (std::size_t i = 0; i < nbPlacements; i++) {
+        float t = ts[i];
+        placedXs[i] = xs[prevs[i]] * (1.0f - t) + xs[nexts[i]] * t;
+        placedYs[i] = ys[prevs[i]] * (1.0f - t) + ys[nexts[i]] * t;
+    }
+    for (std::size_t i = 0; i < nbPlacements; i++) {
+        xs[targets[i]] = placedXs[i];
+        ys[targets[i]] = placedYs[i];
+    }
+}
+
+} // namespace
+
+std::size_t frac::CoordinateStore::addFace(std::size_t nbPoints) {
+    std::size_t first = m_firsts.back();
+    m_firsts.push_back(first + nbPoints);
+    m_xs.resize(first + nbPoints, 0.0f);
+    m_ys.resize(first + nbPoints, 0.0f);
+    return first;
+}
+
+std::size_t frac::CoordinateStore::nbFaces() const {
+    return m_firsts.size() - 1;
+}
+
+bool frac::CoordinateStore::empty() const {
+    return this->nbFaces() == 0;
+}
+
+std::size_t frac::CoordinateStore::size() const {
+    return m_xs.size();
+}
+
+std::size_t frac::CoordinateStore::size(std::size_t face) const {
+    return m_firsts[face + 1] - m_firsts[face];
+}
+
+std::size_t frac::CoordinateStore::first(std::size_t face) const {
+    return m_firsts[face];
+}
+
+float const* frac::CoordinateStore::xs(std::size_t face) const {
+    return m_xs.data() + m_firsts[face];
+}
+
+float const* frac::CoordinateStore::ys(std::size_t face) const {
+    return m_ys.data() + m_firsts[face];
+}
+
+frac::Point2D frac::CoordinateStore::point(std::size_t index) const {
+    return { m_xs[index], m_ys[index] };
+}
+
+void frac::CoordinateStore::set(std::size_t index, frac::Point2D const& point) {
+    m_xs[index] = point.x();
+    m_ys[index] = point.y();
+}
+
+void frac::CoordinateStore::addPlacement(std::size_t target, std::size_t prev, std::size_t next, float t) {
+    m_targets.push_back(static_cast<std::uint32_t>(target));
+    m_prevs.push_back(static_cast<std::uint32_t>(prev));
+    m_nexts.push_back(static_cast<std::uint32_t>(next));
+    m_ts.push_back(t);
+}
+
+void frac::CoordinateStore::place() {
+    for (std::size_t first = 0; first < m_targets.size(); first += s_chunkSize) {
+        std::size_t nbPlacements = std::min(s_chunkSize, m_targets.size() - first);
+        placeChunk(m_xs.data(), m_ys.data(), m_targets.data() + first, m_prevs.data() + first, m_nexts.data() + first, m_ts.data() + first, nbPlacements);
+    }
+    m_targets.clear();
+    m_prevs.clear();
+    m_nexts.clear();
+    m_ts.clear();
+}
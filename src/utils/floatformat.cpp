@@ -0,0 +1,50 @@
+#include "utils/floatformat.h"
+#include <algorithm>
+#include <charconv>
+
+namespace {
+
+template<typename T>
+char* writeShortestOf(char* first, char* last, T value) {
+    char* end = std::to_chars(first, last, value).ptr;
+    // python reads an integer otherwise
+    if (std::all_of(first, end, [](char c) { return c == '-' || (c >= '0' && c <= '9'); })) {
+        *end++ = '.';
+        *end++ = '0';
+    }
+    return end;
+}
+
+} // namespace
+
+char* frac::FloatFormat::write(char* first, float value) const {
+    char* last = first + s_maxLength;
+    if (this->mode == Mode::Fixed) {
+        return std::to_chars(first, last, value, std::chars_format::fixed, static_cast<int>(std::min(this->precision, s_maxPrecision))).ptr;
+    }
+    return writeShortestOf(first, last, value);
+}
+
+char* frac::FloatFormat::writeShortest(char* first, double value) {
+    return writeShortestOf(first, first + s_maxLength, value);
+}
+
+std::string frac::FloatFormat::toString(float value) const {
+    char buffer[s_maxLength];
+    return { buffer, this->write(buffer, value) };
+}
+
+bool frac::FloatFormat::fromStr(std::string const& str, frac::FloatFormat& format) {
+    if (str == "shortest") {
+        format.mode = Mode::Shortest;
+        return true;
+    }
+    unsigned int precision = 0;
+    auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), precision);
+    if (str.empty() || ec != std::errc() || ptr != str.data() + str.size() || precision > s_maxPrecision) {
+        return false;
+    }
+    format.mode = Mode::Fixed;
+    format.precision = precision;
+    return true;
+}
@@ -0,0 +1,100 @@
+#include "utils/libraryindex.h"
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+
+frac::LibraryIndex::Library* frac::LibraryIndex::library(std::string const& libPath, std::string& error) {
+    auto it = m_libraries.find(libPath);
+    if (it == m_libraries.end()) {
+        Library library;
+        if (std::filesystem::is_regular_file(libPath)) {
+            library.pack = std::make_unique<frac::LibraryPack>();
+            if (!library.pack->open(libPath, error)) {
+                return nullptr;
+            }
+        }
+        it = m_libraries.emplace(libPath, std::move(library)).first;
+    }
+    return &it->second;
+}
+
+bool frac::LibraryIndex::open(std::string const& libPath, std::string& error) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return this->library(libPath, error) != nullptr;
+}
+
+std::optional<frac::MatrixBlob> frac::LibraryIndex::matrices(std::string const& libPath, std::string const& key) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    std::string error;
+    Library* library = this->library(libPath, error);
+    if (library == nullptr) {
+        return std::nullopt;
+    }
+    if (library->pack != nullptr) {
+        // the pack is only read once opened
+        lock.unlock();
+        return library->pack->find(key);
+    }
+    auto it = library->cells.find(key);
+    if (it == library->cells.end()) {
+        // the files are read without the lock so that several cells are read at once,
+        // the first read of a cell is kept if another thread read it meanwhile
+        lock.unlock();
+        // a malformed cell is computed again by the script
+        std::optional<std::string> cell = frac::LibraryPack::readCell(libPath, key, error);
+        lock.lock();
+        it = library->cells.emplace(key, cell.has_value() ? std::make_unique<std::string const>(std::move(cell.value())) : nullptr).first;
+    }
+    if (it->second == nullptr) {
+        return std::nullopt;
+    }
+    return frac::MatrixBlob::fromBytes(*it->second);
+}
+
+bool frac::LibraryIndex::save(std::string const& libPath, std::string const& key, std::string_view blob, std::string& error) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Library* library = this->library(libPath, error);
+        if (library == nullptr) {
+            return false;
+        }
+        if (library->pack != nullptr) {
+            error = libPath + ": a library pack is read only";
+            return false;
+        }
+    }
+    // the blob is written next to its file then renamed, so that a reader never sees half of it,
+    // the temporary file is unique to this save, jobs saving the same cell at once do not write in the same file
+    static std::atomic<std::uint64_t> s_nbSaves { 0 };
+    std::filesystem::path path = std::filesystem::path(libPath) / (key + frac::MatrixBlob::s_extension);
+    std::filesystem::path tmpPath = path;
+    tmpPath += "." + std::to_string(::getpid()) + "." + std::to_string(s_nbSaves++) + ".tmp";
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        file.write(blob.data(), static_cast<std::streamsize>(blob.size()));
+        if (!file.good()) {
+            error = tmpPath.string() + ": cannot write the file";
+            return false;
+        }
+    }
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec) {
+        error = path.string() + ": " + ec.message();
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+
+    // the saved blob replaces the one read before, which stays alive for the views on it
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Library& library = m_libraries[libPath];
+    std::unique_ptr<std::string const>& cell = library.cells[key];
+    if (cell != nullptr) {
+        library.replaced.push_back(std::move(cell));
+    }
+    cell = std::make_unique<std::string const>(blob);
+    return true;
+}
@@ -0,0 +1,361 @@
+#include "utils/librarypack.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <set>
+
+namespace {
+
+// records and values are copied as they are in memory, which needs a little endian host
+bool isLittleEndian() {
+    std::uint32_t one = 1;
+    unsigned char firstByte;
+    std::memcpy(&firstByte, &one, 1);
+    return firstByte == 1;
+}
+
+template<typename T>
+T readAt(std::string_view data, std::size_t offset) {
+    T value;
+    std::memcpy(&value, data.data() + offset, sizeof(T));
+    return value;
+}
+
+template<typename T>
+void appendTo(std::string& data, T value) {
+    data.append(reinterpret_cast<char const*>(&value), sizeof(T));
+}
+
+std::size_t alignedOn8(std::size_t size) {
+    return (size + 7) & ~std::size_t(7);
+}
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == ',';
+}
+
+// rows of one matrix, "[[1.0, 2.0], [3.0, 4.0]]" or "[[1. 2.]\n [3. 4.]]", a list of numbers is one row
+bool parseMatrix(std::string_view text, std::vector<std::vector<double>>& rows) {
+    std::size_t start = text.find('[');
+    if (start == std::string_view::npos) {
+        return false;
+    }
+    int depth = 0;
+    for (std::size_t i = start; i < text.size();) {
+        char c = text[i];
+        if (isSpace(c)) {
+            i++;
+        } else if (c == '[') {
+            if (++depth > 2) {
+                return false;
+            }
+            // the outer list of a matrix is not a row
+            if (depth == 2) {
+                rows.emplace_back();
+            }
+            i++;
+        } else if (c == ']') {
+            if (--depth == 0) {
+                break;
+            }
+            i++;
+        } else {
+            double value = 0.0;
+            auto [ptr, ec] = std::from_chars(text.data() + i, text.data() + text.size(), value);
+            if (ec != std::errc() || depth == 0) {
+                return false;
+            }
+            if (rows.empty()) {
+                rows.emplace_back();
+            }
+            rows.back().push_back(value);
+            i = static_cast<std::size_t>(ptr - text.data());
+        }
+    }
+    if (depth != 0 || rows.empty()) {
+        return false;
+    }
+    return std::all_of(rows.begin(), rows.end(), [&](std::vector<double> const& row) { return row.size() == rows.front().size(); });
+}
+
+} // namespace
+
+std::optional<frac::MatrixBlob> frac::MatrixBlob::fromBytes(std::string_view data) {
+    if (data.size() < sizeof(std::uint32_t)) {
+        return std::nullopt;
+    }
+    MatrixBlob blob;
+    blob.m_data = data;
+    std::uint32_t nbMatrices = readAt<std::uint32_t>(data, 0);
+    std::size_t offset = sizeof(std::uint32_t);
+    for (std::uint32_t i = 0; i < nbMatrices; i++) {
+        if (data.size() - offset < 2 * sizeof(std::uint32_t)) {
+            return std::nullopt;
+        }
+        std::uint64_t nbValues = std::uint64_t(readAt<std::uint32_t>(data, offset)) * readAt<std::uint32_t>(data, offset + sizeof(std::uint32_t));
+        if ((data.size() - offset - 2 * sizeof(std::uint32_t)) / sizeof(double) < nbValues) {
+            return std::nullopt;
+        }
+        blob.m_offsets.push_back(offset);
+        offset += 2 * sizeof(std::uint32_t) + nbValues * sizeof(double);
+    }
+    if (offset != data.size()) {
+        return std::nullopt;
+    }
+    return blob;
+}
+
+void frac::MatrixBlob::begin(std::string& blob, std::uint32_t nbMatrices) {
+    blob.clear();
+    appendTo(blob, nbMatrices);
+}
+
+void frac::MatrixBlob::appendMatrix(std::string& blob, std::uint32_t nbRows, std::uint32_t nbColumns, double const* values) {
+    appendTo(blob, nbRows);
+    appendTo(blob, nbColumns);
+    blob.append(reinterpret_cast<char const*>(values), std::size_t(nbRows) * nbColumns * sizeof(double));
+}
+
+bool frac::MatrixBlob::fromText(std::vector<std::string> const& texts, std::string& blob, std::string& error) {
+    begin(blob, static_cast<std::uint32_t>(texts.size()));
+    for (std::size_t i = 0; i < texts.size(); i++) {
+        std::vector<std::vector<double>> rows;
+        if (!parseMatrix(texts[i], rows)) {
+            error = "matrix " + std::to_string(i) + " is not a list of rows of numbers";
+            return false;
+        }
+        std::vector<double> values;
+        for (std::vector<double> const& row: rows) {
+            values.insert(values.end(), row.begin(), row.end());
+        }
+        appendMatrix(blob, static_cast<std::uint32_t>(rows.size()), static_cast<std::uint32_t>(rows.front().size()), values.data());
+    }
+    return true;
+}
+
+std::size_t frac::MatrixBlob::size() const {
+    return m_offsets.size();
+}
+
+std::string_view frac::MatrixBlob::bytes() const {
+    return m_data;
+}
+
+std::uint32_t frac::MatrixBlob::nbRows(std::size_t matrix) const {
+    return readAt<std::uint32_t>(m_data, m_offsets[matrix]);
+}
+
+std::uint32_t frac::MatrixBlob::nbColumns(std::size_t matrix) const {
+    return readAt<std::uint32_t>(m_data, m_offsets[matrix] + sizeof(std::uint32_t));
+}
+
+double frac::MatrixBlob::value(std::size_t matrix, std::uint32_t row, std::uint32_t column) const {
+    std::size_t index = std::size_t(row) * this->nbColumns(matrix) + column;
+    return readAt<double>(m_data, m_offsets[matrix] + 2 * sizeof(std::uint32_t) + index * sizeof(double));
+}
+
+std::uint64_t frac::LibraryPack::hash(std::string_view key) {
+    std::uint64_t res = 14695981039346656037ull;
+    for (char c: key) {
+        res ^= static_cast<unsigned char>(c);
+        res *= 1099511628211ull;
+    }
+    return res;
+}
+
+bool frac::LibraryPack::write(std::string const& filename, std::vector<Entry> entries, std::string& error) {
+    if (!isLittleEndian()) {
+        error = filename + ": the library pack needs a little endian host";
+        return false;
+    }
+    // the same entries give the same file
+    std::sort(entries.begin(), entries.end(), [](Entry const& a, Entry const& b) { return a.key < b.key; });
+    for (std::size_t i = 0; i < entries.size(); i++) {
+        if (entries[i].key.empty() || (i > 0 && entries[i].key == entries[i - 1].key)) {
+            error = filename + ": empty or duplicated key \"" + entries[i].key + "\"";
+            return false;
+        }
+    }
+
+    // at most half of the slots are used so that probes stay short
+    std::size_t nbSlots = 1;
+    while (nbSlots < 2 * entries.size()) {
+        nbSlots *= 2;
+    }
+    std::vector<Slot> slots(nbSlots, Slot {});
+    std::string keys;
+    std::size_t keysOffset = sizeof(Header) + nbSlots * sizeof(Slot);
+    for (Entry const& e: entries) {
+        keys += e.key;
+    }
+    std::size_t blobOffset = alignedOn8(keysOffset + keys.size());
+    std::size_t keyOffset = keysOffset;
+    for (Entry const& e: entries) {
+        std::uint64_t h = hash(e.key);
+        std::size_t slot = h & (nbSlots - 1);
+        while (slots[slot].keyLength != 0) {
+            slot = (slot + 1) & (nbSlots - 1);
+        }
+        slots[slot] = { h, keyOffset, blobOffset, static_cast<std::uint32_t>(e.key.size()), static_cast<std::uint32_t>(e.blob.size()) };
+        keyOffset += e.key.size();
+        blobOffset = alignedOn8(blobOffset + e.blob.size());
+    }
+
+    Header header {};
+    std::memcpy(header.magic, s_magic, sizeof(s_magic));
+    header.version = s_version;
+    header.nbSlots = static_cast<std::uint32_t>(nbSlots);
+    header.nbEntries = static_cast<std::uint32_t>(entries.size());
+
+    char const padding[8] = {};
+    std::ofstream file(filename, std::ofstream::out | std::ofstream::trunc | std::ofstream::binary);
+    file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+    file.write(reinterpret_cast<char const*>(slots.data()), static_cast<std::streamsize>(slots.size() * sizeof(Slot)));
+    file.write(keys.data(), static_cast<std::streamsize>(keys.size()));
+    file.write(padding, static_cast<std::streamsize>(alignedOn8(keysOffset + keys.size()) - keysOffset - keys.size()));
+    for (Entry const& e: entries) {
+        file.write(e.blob.data(), static_cast<std::streamsize>(e.blob.size()));
+        file.write(padding, static_cast<std::streamsize>(alignedOn8(e.blob.size()) - e.blob.size()));
+    }
+    file.close();
+    if (!file) {
+        error = filename + ": cannot write the file";
+        return false;
+    }
+    return true;
+}
+
+std::string frac::LibraryPack::keyOf(std::string_view cellName) {
+    std::string res;
+    res.reserve(cellName.size() + 8);
+    for (char c: cellName) {
+        if (c == '/') {
+            res += "--";
+        } else if (c != ' ') {
+            res += c;
+        }
+    }
+    return res;
+}
+
+std::optional<std::string> frac::LibraryPack::readCell(std::string const& folderpath, std::string const& key, std::string& error) {
+    std::filesystem::path folder(folderpath);
+    // a blob is saved after the text files of the same cell, it replaces them
+    std::filesystem::path blobPath = folder / (key + MatrixBlob::s_extension);
+    if (std::filesystem::is_regular_file(blobPath)) {
+        frac::MappedFile file;
+        if (!file.open(blobPath.string()) || !MatrixBlob::fromBytes(file.content()).has_value()) {
+            error = blobPath.string() + ": not a matrix blob";
+            return std::nullopt;
+        }
+        return std::string(file.content());
+    }
+    std::filesystem::path path = folder / key;
+    if (!std::filesystem::is_directory(path)) {
+        return std::nullopt;
+    }
+    // text files 0, 1... saved by the previous scripts
+    std::vector<std::string> texts;
+    for (std::filesystem::path file = path / "0"; std::filesystem::is_regular_file(file); file = path / std::to_string(texts.size())) {
+        std::ifstream ifs(file);
+        texts.emplace_back((std::istreambuf_iterator<char>(ifs)), (std::istreambuf_iterator<char>()));
+    }
+    std::string blob;
+    if (!MatrixBlob::fromText(texts, blob, error)) {
+        error = path.string() + ": " + error;
+        return std::nullopt;
+    }
+    return blob;
+}
+
+bool frac::LibraryPack::readFolder(std::string const& folderpath, std::vector<Entry>& entries, std::string& error) {
+    std::error_code ec;
+    std::set<std::string> keys;
+    for (auto it = std::filesystem::directory_iterator(folderpath, ec); !ec && it != std::filesystem::directory_iterator(); it.increment(ec)) {
+        std::filesystem::path const& path = it->path();
+        if (it->is_directory()) {
+            keys.insert(path.filename().string());
+        } else if (path.extension() == MatrixBlob::s_extension) {
+            keys.insert(path.stem().string());
+        }
+    }
+    if (ec) {
+        error = folderpath + ": cannot read the folder";
+        return false;
+    }
+
+    entries.clear();
+    for (std::string const& key: keys) {
+        std::optional<std::string> blob = readCell(folderpath, key, error);
+        if (!blob.has_value()) {
+            return false;
+        }
+        entries.push_back({ key, std::move(blob.value()) });
+    }
+    return true;
+}
+
+bool frac::LibraryPack::open(std::string const& filename, std::string& error) {
+    m_header = {};
+    if (!isLittleEndian()) {
+        error = filename + ": the library pack needs a little endian host";
+        return false;
+    }
+    if (!m_file.open(filename)) {
+        error = filename + ": cannot read the file";
+        return false;
+    }
+    std::string_view data = m_file.content();
+    if (data.size() < sizeof(Header)) {
+        m_file.close();
+        error = filename + ": not a library pack";
+        return false;
+    }
+    Header header = readAt<Header>(data, 0);
+    if (std::memcmp(header.magic, s_magic, sizeof(s_magic)) != 0 || header.version != s_version) {
+        m_file.close();
+        error = filename + ": not a library pack of version " + std::to_string(s_version);
+        return false;
+    }
+    // a power of 2 is needed by find, the index and every key and blob must be in the file
+    bool valid = header.nbSlots != 0 && (header.nbSlots & (header.nbSlots - 1)) == 0 && header.nbEntries <= header.nbSlots
+            && (data.size() - sizeof(Header)) / sizeof(Slot) >= header.nbSlots;
+    for (std::uint32_t i = 0; valid && i < header.nbSlots; i++) {
+        Slot slot = readAt<Slot>(data, sizeof(Header) + i * sizeof(Slot));
+        valid = slot.keyLength == 0 || (slot.keyOffset <= data.size() && data.size() - slot.keyOffset >= slot.keyLength
+                                        && slot.blobOffset <= data.size() && data.size() - slot.blobOffset >= slot.blobSize);
+    }
+    if (!valid) {
+        m_file.close();
+        error = filename + ": the index of the library pack is corrupted";
+        return false;
+    }
+    m_header = header;
+    return true;
+}
+
+std::optional<frac::MatrixBlob> frac::LibraryPack::find(std::string_view key) const {
+    if (m_header.nbSlots == 0 || key.empty()) {
+        return std::nullopt;
+    }
+    std::string_view data = m_file.content();
+    std::uint64_t h = hash(key);
+    std::size_t mask = m_header.nbSlots - 1;
+    for (std::size_t i = h & mask, nbProbes = 0; nbProbes < m_header.nbSlots; i = (i + 1) & mask, nbProbes++) {
+        Slot slot = readAt<Slot>(data, sizeof(Header) + i * sizeof(Slot));
+        if (slot.keyLength == 0) {
+            return std::nullopt;
+        }
+        if (slot.hash == h && data.substr(slot.keyOffset, slot.keyLength) == key) {
+            return MatrixBlob::fromBytes(data.substr(slot.blobOffset, slot.blobSize));
+        }
+    }
+    return std::nullopt;
+}
+
+std::size_t frac::LibraryPack::size() const {
+    return m_header.nbEntries;
+}
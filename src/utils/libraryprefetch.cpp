@@ -0,0 +1,32 @@
+#include "utils/libraryprefetch.h"
+#include "utils/workstealingpool.h"
+
+#include <algorithm>
+
+frac::LibraryPrefetch::LibraryPrefetch(frac::LibraryIndex& library, std::string libPath, std::vector<std::string> keys, unsigned int nbThreads) :
+        m_library(library), m_libPath(std::move(libPath)), m_keys(std::move(keys)), m_results(m_keys.size()) {
+    if (m_keys.empty()) {
+        return;
+    }
+    nbThreads = static_cast<unsigned int>(std::min<std::size_t>(std::max(1u, nbThreads), m_keys.size()));
+    // each lookup writes its own result, the results are read once the thread is joined
+    m_thread = std::thread([this, nbThreads] {
+        frac::WorkStealingPool pool(nbThreads);
+        pool.run(m_keys.size(), [this](std::size_t i) {
+            m_results[i] = m_library.matrices(m_libPath, m_keys[i]);
+        });
+    });
+}
+
+frac::LibraryPrefetch::~LibraryPrefetch() {
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+std::vector<std::optional<frac::MatrixBlob>> const& frac::LibraryPrefetch::results() {
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    return m_results;
+}
@@ -0,0 +1,48 @@
+#include "utils/mappedfile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+frac::MappedFile::~MappedFile() {
+    this->close();
+}
+
+bool frac::MappedFile::open(std::string const& filename) {
+    this->close();
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info {};
+    if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        ::close(fd);
+        return false;
+    }
+    if (info.st_size > 0) {
+        void* data = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            ::close(fd);
+            return false;
+        }
+        ::madvise(data, static_cast<std::size_t>(info.st_size), MADV_SEQUENTIAL);
+        m_data = static_cast<char const*>(data);
+        m_size = static_cast<std::size_t>(info.st_size);
+    }
+    // the mapping stays valid once the file is closed
+    ::close(fd);
+    return true;
+}
+
+void frac::MappedFile::close() {
+    if (m_data != nullptr) {
+        ::munmap(const_cast<char*>(m_data), m_size);
+    }
+    m_data = nullptr;
+    m_size = 0;
+}
+
+std::string_view frac::MappedFile::content() const {
+    return { m_data, m_size };
+}
@@ -0,0 +1,141 @@
+#include "utils/outputsink.h"
+#include <charconv>
+#include <cstring>
+
+frac::OutputSink::OutputSink(std::size_t bufferSize) : m_buffer(bufferSize == 0 ? 1 : bufferSize) {}
+
+void frac::OutputSink::append(std::string_view text) {
+    if (m_size + text.size() > m_buffer.size()) {
+        this->flush();
+        if (text.size() >= m_buffer.size()) {
+            // too large for the buffer, no need to copy it
+            m_good = this->write(text.data(), text.size()) && m_good;
+            return;
+        }
+    }
+    std::memcpy(m_buffer.data() + m_size, text.data(), text.size());
+    m_size += text.size();
+}
+
+void frac::OutputSink::append_nl(std::string_view text) {
+    this->append(text);
+    this->append("\n");
+}
+
+void frac::OutputSink::appendFloat(float value, frac::FloatFormat const& format) {
+    char* first = this->reserve(frac::FloatFormat::s_maxLength);
+    if (first == nullptr) {
+        char text[frac::FloatFormat::s_maxLength];
+        this->append({ text, static_cast<std::size_t>(format.write(text, value) - text) });
+        return;
+    }
+    m_size += static_cast<std::size_t>(format.write(first, value) - first);
+}
+
+void frac::OutputSink::appendDouble(double value) {
+    char* first = this->reserve(frac::FloatFormat::s_maxLength);
+    if (first == nullptr) {
+        char text[frac::FloatFormat::s_maxLength];
+        this->append({ text, static_cast<std::size_t>(frac::FloatFormat::writeShortest(text, value) - text) });
+        return;
+    }
+    m_size += static_cast<std::size_t>(frac::FloatFormat::writeShortest(first, value) - first);
+}
+
+void frac::OutputSink::appendInteger(unsigned long long value) {
+    char* first = this->reserve(s_maxIntegerLength);
+    if (first == nullptr) {
+        char text[s_maxIntegerLength];
+        this->append({ text, static_cast<std::size_t>(std::to_chars(text, text + s_maxIntegerLength, value).ptr - text) });
+        return;
+    }
+    m_size += static_cast<std::size_t>(std::to_chars(first, first + s_maxIntegerLength, value).ptr - first);
+}
+
+void frac::OutputSink::appendInteger(long long value) {
+    char* first = this->reserve(s_maxIntegerLength);
+    if (first == nullptr) {
+        char text[s_maxIntegerLength];
+        this->append({ text, static_cast<std::size_t>(std::to_chars(text, text + s_maxIntegerLength, value).ptr - text) });
+        return;
+    }
+    m_size += static_cast<std::size_t>(std::to_chars(first, first + s_maxIntegerLength, value).ptr - first);
+}
+
+void frac::OutputSink::put(char c) {
+    if (m_size == m_buffer.size()) {
+        this->flush();
+    }
+    m_buffer[m_size++] = c;
+}
+
+char* frac::OutputSink::reserve(std::size_t size) {
+    if (m_buffer.size() < size) {
+        return nullptr;
+    }
+    if (m_size + size > m_buffer.size()) {
+        this->flush();
+    }
+    return m_buffer.data() + m_size;
+}
+
+bool frac::OutputSink::flush() {
+    if (m_size != 0) {
+        m_good = this->write(m_buffer.data(), m_size) && m_good;
+        m_size = 0;
+    }
+    return m_good;
+}
+
+bool frac::OutputSink::good() const {
+    return m_good;
+}
+
+void frac::OutputSink::release() {
+    this->flush();
+}
+
+frac::FileSink::FileSink(std::size_t bufferSize) : OutputSink(bufferSize) {}
+
+frac::FileSink::~FileSink() {
+    this->release();
+}
+
+bool frac::FileSink::open(std::string const& filename) {
+    this->flush();
+    m_file.close();
+    m_file.open(filename, std::ofstream::out | std::ofstream::trunc);
+    return m_file.is_open();
+}
+
+bool frac::FileSink::write(char const* data, std::size_t size) {
+    m_file.write(data, static_cast<std::streamsize>(size));
+    return m_file.good();
+}
+
+frac::StreamSink::StreamSink(std::ostream& stream, std::size_t bufferSize) : OutputSink(bufferSize), m_stream(stream) {}
+
+frac::StreamSink::~StreamSink() {
+    this->release();
+}
+
+bool frac::StreamSink::write(char const* data, std::size_t size) {
+    m_stream.write(data, static_cast<std::streamsize>(size));
+    m_stream.flush();
+    return m_stream.good();
+}
+
+frac::MemorySink::MemorySink(std::size_t bufferSize) : OutputSink(bufferSize) {}
+
+frac::MemorySink::~MemorySink() {
+    this->release();
+}
+
+std::string const& frac::MemorySink::content() const {
+    return m_content;
+}
+
+bool frac::MemorySink::write(char const* data, std::size_t size) {
+    m_content.append(data, size);
+    return true;
+}
@@ -0,0 +1,119 @@
+#include "utils/workstealingpool.h"
+
+#include <algorithm>
+
+frac::WorkStealingPool::WorkStealingPool(unsigned int nbThreads) {
+    nbThreads = std::clamp(nbThreads, 1u, s_maxThreads);
+    for (unsigned int i = 0; i < nbThreads; i++) {
+        m_queues.emplace_back(std::make_unique<Queue>());
+    }
+    for (unsigned int i = 1; i < nbThreads; i++) {
+        m_threads.emplace_back(&WorkStealingPool::loop, this, i);
+    }
+}
+
+frac::WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_batchStarted.notify_all();
+    for (std::thread& t: m_threads) {
+        t.join();
+    }
+}
+
+void frac::WorkStealingPool::run(std::size_t nbTasks, std::function<void(std::size_t)> const& task) {
+    if (nbTasks == 0) {
+        return;
+    }
+    if (m_threads.empty() || nbTasks == 1) {
+        for (std::size_t i = 0; i < nbTasks; i++) {
+            task(i);
+        }
+        return;
+    }
+
+    {
+        // the task is set before the queues are filled, a thread that takes a task then sees it
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_task = &task;
+        m_remainingTasks = nbTasks;
+    }
+
+    // consecutive tasks go to the same queue
+    std::size_t nbQueues = m_queues.size();
+    for (std::size_t q = 0; q < nbQueues; q++) {
+        std::lock_guard<std::mutex> lock(m_queues[q]->mutex);
+        for (std::size_t i = q * nbTasks / nbQueues; i < (q + 1) * nbTasks / nbQueues; i++) {
+            m_queues[q]->tasks.push_back(i);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_batch++;
+    }
+    m_batchStarted.notify_all();
+
+    this->work(0);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_batchDone.wait(lock, [this] { return m_remainingTasks == 0; });
+    m_task = nullptr;
+}
+
+unsigned int frac::WorkStealingPool::nbThreads() const {
+    return static_cast<unsigned int>(m_queues.size());
+}
+
+void frac::WorkStealingPool::loop(unsigned int index) {
+    std::size_t batch = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_batchStarted.wait(lock, [this, batch] { return m_stop || m_batch != batch; });
+            if (m_stop) {
+                return;
+            }
+            batch = m_batch;
+        }
+        this->work(index);
+    }
+}
+
+void frac::WorkStealingPool::work(unsigned int index) {
+    std::size_t task;
+    while (this->takeTask(index, task)) {
+        (*m_task)(task);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_remainingTasks--;
+        if (m_remainingTasks == 0) {
+            m_batchDone.notify_all();
+        }
+    }
+}
+
+bool frac::WorkStealingPool::takeTask(unsigned int index, std::size_t& task) {
+    {
+        // own tasks are taken from the back
+        Queue& own = *m_queues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = own.tasks.back();
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+    // other tasks are stolen from the front
+    for (std::size_t i = 1; i < m_queues.size(); i++) {
+        Queue& other = *m_queues[(index + i) % m_queues.size()];
+        std::lock_guard<std::mutex> lock(other.mutex);
+        if (!other.tasks.empty()) {
+            task = other.tasks.front();
+            other.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}